@@ -0,0 +1,26 @@
+# add_dfa_matcher(<target> <name> <regex> [STYLE switch|table])
+#
+# Compiles the regex into a DFA matcher at build time and makes the header
+# <name>.hpp with the function `bool <name>(std::string_view)` available to
+# the target. The regex is in the format the engine prints regexes in.
+
+function(add_dfa_matcher TARGET NAME REGEX)
+    cmake_parse_arguments(MATCHER "" "STYLE" "" ${ARGN})
+    if (NOT MATCHER_STYLE)
+        set(MATCHER_STYLE switch)
+    endif ()
+
+    set(OUTPUT_DIR ${CMAKE_CURRENT_BINARY_DIR}/generated/${TARGET})
+    set(OUTPUT ${OUTPUT_DIR}/${NAME}.hpp)
+
+    add_custom_command(
+            OUTPUT ${OUTPUT}
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${OUTPUT_DIR}
+            COMMAND formal_languages_codegen --name ${NAME} --style ${MATCHER_STYLE} --output ${OUTPUT} ${REGEX}
+            DEPENDS formal_languages_codegen
+            COMMENT "Generating DFA matcher ${NAME}"
+            VERBATIM)
+
+    target_sources(${TARGET} PRIVATE ${OUTPUT})
+    target_include_directories(${TARGET} PRIVATE ${OUTPUT_DIR})
+endfunction()
@@ -0,0 +1,546 @@
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include "../engine/regex.hpp"
+#include "../engine/finite-automaton.hpp"
+#include "../engine/automaton-simplifier.hpp"
+#include "../engine/epsilon-remover.hpp"
+#include "../engine/automaton-optimizer.hpp"
+#include "../engine/automaton-completer.hpp"
+#include "../engine/automaton-determinator.hpp"
+#include "../engine/automaton-minifier.hpp"
+#include "../engine/random-generator.hpp"
+#include "../engine/glushkov-automaton-builder.hpp"
+#include "../engine/antimirov-automaton-builder.hpp"
+#include "../engine/parallel-automaton-minifier.hpp"
+#include "../engine/brzozowski-minifier.hpp"
+#include "../engine/pattern-compiler.hpp"
+#include "../engine/pattern-searcher.hpp"
+#include "../engine/sheng-dfa.hpp"
+#include "../engine/interleaved-dfa-matcher.hpp"
+#include "../engine/parallel-dfa-matcher.hpp"
+#include "../engine/batch-matcher.hpp"
+
+// Prints scaling curves of the pipeline stages as CSV.
+// Usage: formal_languages_benchmark [mode] [--seed N] [--samples N]
+
+struct BenchmarkOptions {
+    uint64_t seed = 1;
+    size_t samples = 3;
+};
+
+template<typename F>
+double measure_ms(F &&function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void benchmark_regex_scaling(const BenchmarkOptions &options) {
+    std::cout << "regex_size,sample,nfa_states,dfa_states,min_states,"
+                 "simplify_ms,epsilon_ms,optimize_ms,complete_ms,determine_ms,minify_ms\n";
+
+    for (size_t size = 8; size <= 256; size *= 2) {
+        for (size_t sample = 0; sample < options.samples; sample++) {
+            RandomRegexConfig config;
+            config.alphabet = "abc";
+            config.size = size;
+            config.max_depth = 12;
+
+            Regex regex = RandomRegexGenerator(config, options.seed + sample).generate();
+            FiniteAutomaton automaton(regex);
+            automaton.extend_alphabet({'a', 'b', 'c'});
+
+            double simplify_ms = measure_ms([&] { AutomatonSimplifier(automaton).simplify(); });
+            double epsilon_ms = measure_ms([&] { EpsilonRemover(automaton).simplify(); });
+            double optimize_ms = measure_ms([&] { AutomatonOptimizer(automaton).optimize(); });
+            size_t nfa_states = automaton.get_states().size();
+            double complete_ms = measure_ms([&] { AutomatonCompleter(automaton).complete(); });
+            double determine_ms = measure_ms([&] { automaton = AutomatonDeterminator(automaton).determine(); });
+            size_t dfa_states = automaton.get_states().size();
+            double minify_ms = measure_ms([&] { automaton = AutomatonMinifier(automaton).minify(); });
+
+            std::cout << size << "," << sample << "," << nfa_states << "," << dfa_states << ","
+                      << automaton.get_states().size() << "," << simplify_ms << "," << epsilon_ms << ","
+                      << optimize_ms << "," << complete_ms << "," << determine_ms << "," << minify_ms << "\n";
+        }
+    }
+}
+
+void benchmark_automaton_scaling(const BenchmarkOptions &options) {
+    std::cout << "nfa_states,sample,dfa_states,min_states,complete_ms,determine_ms,minify_ms\n";
+
+    for (size_t state_count = 4; state_count <= 64; state_count *= 2) {
+        for (size_t sample = 0; sample < options.samples; sample++) {
+            RandomAutomatonConfig config;
+            config.state_count = state_count;
+            config.density = 0.5;
+            config.determinism = 0.7;
+
+            FiniteAutomaton automaton = RandomAutomatonGenerator(config, options.seed + sample).generate();
+
+            double complete_ms = measure_ms([&] { AutomatonCompleter(automaton).complete(); });
+            double determine_ms = measure_ms([&] { automaton = AutomatonDeterminator(automaton).determine(); });
+            size_t dfa_states = automaton.get_states().size();
+            double minify_ms = measure_ms([&] { automaton = AutomatonMinifier(automaton).minify(); });
+
+            std::cout << state_count << "," << sample << "," << dfa_states << ","
+                      << automaton.get_states().size() << "," << complete_ms << "," << determine_ms << ","
+                      << minify_ms << "\n";
+        }
+    }
+}
+
+size_t count_transitions(const FiniteAutomaton &automaton) {
+    size_t count = 0;
+    for (auto &state: automaton.get_states()) {
+        count += state.transitions.size();
+    }
+    return count;
+}
+
+// Compares the NFA construction front ends on a corpus of random patterns:
+// Thompson-style (simplifier + epsilon remover), Glushkov and Antimirov.
+// Every line reports the NFA size, DFA size and compile time up to the DFA.
+void benchmark_front_ends(const BenchmarkOptions &options) {
+    std::cout << "pattern,regex_size,front_end,nfa_states,nfa_transitions,dfa_states,nfa_ms,determine_ms,best\n";
+
+    std::set<char> alphabet = {'a', 'b', 'c'};
+    size_t pattern = 0;
+
+    for (size_t size = 8; size <= 128; size *= 2) {
+        for (size_t sample = 0; sample < options.samples; sample++, pattern++) {
+            RandomRegexConfig config;
+            config.alphabet = "abc";
+            config.size = size;
+            config.max_depth = 12;
+
+            Regex regex = RandomRegexGenerator(config, options.seed + pattern).generate();
+
+            std::vector<std::pair<std::string, std::function<FiniteAutomaton()>>> front_ends = {
+                    {"thompson",  [&] {
+                        FiniteAutomaton automaton(regex);
+                        automaton.extend_alphabet(alphabet);
+                        AutomatonSimplifier(automaton).simplify();
+                        EpsilonRemover(automaton).simplify();
+                        AutomatonOptimizer(automaton).optimize();
+                        return automaton;
+                    }},
+                    {"glushkov",  [&] { return GlushkovAutomatonBuilder(regex, alphabet).build(); }},
+                    {"antimirov", [&] { return AntimirovAutomatonBuilder(regex, alphabet).build(); }},
+            };
+
+            std::vector<std::string> lines;
+            std::string best;
+            double best_ms = 0;
+
+            for (auto &[name, build]: front_ends) {
+                FiniteAutomaton automaton;
+                double nfa_ms = measure_ms([&] { automaton = build(); });
+                size_t nfa_states = automaton.get_states().size();
+                size_t nfa_transitions = count_transitions(automaton);
+
+                double determine_ms = measure_ms([&] {
+                    AutomatonCompleter(automaton).complete();
+                    automaton = AutomatonDeterminator(automaton).determine();
+                });
+
+                if (best.empty() || nfa_ms + determine_ms < best_ms) {
+                    best = name;
+                    best_ms = nfa_ms + determine_ms;
+                }
+
+                std::stringstream line;
+                line << pattern << "," << size << "," << name << "," << nfa_states << "," << nfa_transitions << ","
+                     << automaton.get_states().size() << "," << nfa_ms << "," << determine_ms;
+                lines.push_back(line.str());
+            }
+
+            for (auto &line: lines) {
+                std::cout << line << "," << best << "\n";
+            }
+        }
+    }
+}
+
+void benchmark_parallel_minify(const BenchmarkOptions &options) {
+    ThreadPool pool;
+    std::cout << "threads," << pool.get_thread_count() << "\n";
+    std::cout << "dfa_states,sample,min_states,serial_ms,parallel_ms\n";
+
+    for (size_t state_count = 1024; state_count <= 65536; state_count *= 4) {
+        for (size_t sample = 0; sample < options.samples; sample++) {
+            RandomAutomatonConfig config;
+            config.state_count = state_count;
+            config.density = 1.0;
+
+            FiniteAutomaton automaton = RandomAutomatonGenerator(config, options.seed + sample).generate();
+            FiniteAutomaton serial, parallel;
+
+            double serial_ms = measure_ms([&] { serial = AutomatonMinifier(automaton).minify(); });
+            double parallel_ms = measure_ms([&] { parallel = ParallelAutomatonMinifier(automaton, pool).minify(); });
+            assert(serial.get_states().size() == parallel.get_states().size());
+
+            std::cout << state_count << "," << sample << "," << parallel.get_states().size() << "," << serial_ms
+                      << "," << parallel_ms << "\n";
+        }
+    }
+}
+
+// Compares the two ways from an NFA to the minimal DFA: subset construction
+// followed by AutomatonMinifier, and Brzozowski's double reversal. Random
+// NFAs and random patterns are mixed with (a + b)*a(a + b)^n, whose DFA is
+// exponential, and its reversal (a + b)^n a(a + b)*, whose DFA is linear.
+void benchmark_minimize_paths(const BenchmarkOptions &options) {
+    std::cout << "family,size,sample,nfa_states,dfa_states,min_states,subset_ms,brzozowski_ms,best\n";
+
+    auto report = [&](const std::string &family, size_t size, size_t sample, const FiniteAutomaton &nfa) {
+        FiniteAutomaton dfa, minimal, brzozowski;
+
+        double subset_ms = measure_ms([&] {
+            dfa = AutomatonDeterminator(nfa).determine();
+            minimal = AutomatonMinifier(dfa).minify();
+        });
+        double brzozowski_ms = measure_ms([&] { brzozowski = BrzozowskiMinifier(nfa).minify(); });
+
+        std::cout << family << "," << size << "," << sample << "," << nfa.get_states().size() << ","
+                  << dfa.get_states().size() << "," << brzozowski.get_states().size() << "," << subset_ms << ","
+                  << brzozowski_ms << "," << (subset_ms <= brzozowski_ms ? "subset" : "brzozowski") << "\n";
+    };
+
+    for (size_t n = 4; n <= 12; n += 4) {
+        Regex any = "a"_r + "b"_r;
+        Regex suffix = *Regex(any) * "a"_r;
+        Regex prefix = "a"_r * *Regex(any);
+        for (size_t i = 1; i < n; i++) {
+            suffix *= any;
+            prefix = any * prefix;
+        }
+
+        report("nth-from-end", n, 0, GlushkovAutomatonBuilder(suffix).build());
+        report("nth-from-start", n, 0, GlushkovAutomatonBuilder(prefix).build());
+    }
+
+    for (size_t size = 16; size <= 128; size *= 2) {
+        for (size_t sample = 0; sample < options.samples; sample++) {
+            RandomRegexConfig config;
+            config.alphabet = "abc";
+            config.size = size;
+            config.max_depth = 12;
+
+            Regex regex = RandomRegexGenerator(config, options.seed + sample).generate();
+            report("random-regex", size, sample, GlushkovAutomatonBuilder(regex).build());
+        }
+    }
+
+    // The reversed DFA of a random NFA quickly gets huge, so the sizes stay small
+    for (size_t state_count = 8; state_count <= 32; state_count *= 2) {
+        for (size_t sample = 0; sample < options.samples; sample++) {
+            RandomAutomatonConfig config;
+            config.state_count = state_count;
+            config.density = 0.5;
+            config.determinism = 0.7;
+
+            report("random-nfa", state_count, sample,
+                   RandomAutomatonGenerator(config, options.seed + sample).generate());
+        }
+    }
+}
+
+// Matching throughput of the table-driven DFA, the shuffle one (for DFAs which
+// fit) and the JIT-compiled one, in MB/s over a few megabytes of input which
+// never reaches the dead state
+void benchmark_jit(const BenchmarkOptions &options) {
+    std::cout << "pattern,dfa_states,native,code_bytes,table_mb_s,sheng_mb_s,jit_mb_s\n";
+
+    std::vector<std::pair<std::string, Regex>> patterns;
+    for (size_t n = 2; n <= 10; n += 4) {
+        Regex any = "a"_r + "b"_r;
+        Regex regex = *Regex(any) * "a"_r;
+        for (size_t i = 1; i < n; i++) {
+            regex *= any;
+        }
+        patterns.emplace_back("nth-from-end-" + std::to_string(n), regex);
+    }
+
+    // Many byte ranges per state, which go through jump tables
+    Regex letters = Regex::zero();
+    for (char c = 'a'; c <= 'z'; c += 2) {
+        letters += Regex(CharRegex(c)) + Regex(CharRegex(static_cast<char>(c + 1))) * "a"_r;
+    }
+    patterns.emplace_back("alternating-letters", *letters);
+
+    for (auto &[name, regex]: patterns) {
+        CompiledPattern pattern = PatternCompiler(regex).compile();
+        JitCompiledDfa jit(pattern.get_dfa());
+        ShengDfa sheng(pattern.get_dfa());
+
+        RandomSource random(options.seed);
+        std::string alphabet = name == "alternating-letters" ? "acegikmoqsuwy" : "ab";
+        std::string input(4 << 20, ' ');
+        for (auto &c: input) {
+            c = random.next_char(alphabet);
+        }
+
+        size_t table_accepted = 0, sheng_accepted = 0, jit_accepted = 0;
+        double table_ms = 0, sheng_ms = 0, jit_ms = 0;
+        for (size_t sample = 0; sample < options.samples; sample++) {
+            table_ms += measure_ms([&] { table_accepted += pattern.get_dfa().accepts(input); });
+            sheng_ms += measure_ms([&] { sheng_accepted += sheng.accepts(input); });
+            jit_ms += measure_ms([&] { jit_accepted += jit.accepts(input); });
+        }
+        assert(table_accepted == jit_accepted && table_accepted == sheng_accepted);
+
+        double megabytes = static_cast<double>(input.size()) * static_cast<double>(options.samples) / (1 << 20);
+        std::cout << name << "," << pattern.get_dfa().get_state_count() << "," << jit.is_native() << ","
+                  << jit.get_code_size() << "," << megabytes / table_ms * 1000 << ",";
+        if (sheng.is_vectorized()) {
+            std::cout << megabytes / sheng_ms * 1000;
+        }
+        std::cout << "," << megabytes / jit_ms * 1000 << "\n";
+    }
+}
+
+// Search time with and without the literal prefilter, over a few megabytes
+// of random lowercase text with a single match close to its end
+void benchmark_prefilter(const BenchmarkOptions &options) {
+    std::cout << "pattern,strategy,required,prefilter_ms,plain_ms\n";
+
+    Regex lowercase = Regex::zero();
+    for (char c = 'a'; c <= 'z'; c++) {
+        lowercase += Regex(CharRegex(c));
+    }
+
+    std::vector<std::tuple<std::string, Regex, std::string>> patterns = {
+            {"prefix", "error"_r * *Regex(lowercase) * "x"_r,                    "errorqqx"},
+            {"suffix", *Regex(lowercase) * "failed"_r,                           "failed"},
+            {"inner",  (lowercase * lowercase) * "timeout"_r * (lowercase + "z"_r), "qqtimeoutz"},
+    };
+
+    RandomSource random(options.seed);
+    std::string text(4 << 20, ' ');
+    for (auto &c: text) {
+        // Spaces keep the unanchored scan from matching the suffix pattern everywhere
+        c = random.next_bool(0.2) ? ' ' : static_cast<char>('a' + random.next_index(26));
+    }
+
+    const char *strategies[] = {"unanchored", "prefix", "suffix", "inner"};
+
+    for (auto &[name, regex, needle]: patterns) {
+        std::string haystack = text;
+        haystack.replace(haystack.size() - 64, needle.size(), needle);
+
+        PatternSearcher searcher(regex);
+        PatternSearcher plain(regex, false);
+
+        std::optional<PatternMatch> expected = plain.find(haystack), found;
+        double prefilter_ms = 0, plain_ms = 0;
+        for (size_t sample = 0; sample < options.samples; sample++) {
+            prefilter_ms += measure_ms([&] { found = searcher.find(haystack); });
+            plain_ms += measure_ms([&] { expected = plain.find(haystack); });
+        }
+        assert(found == expected);
+
+        std::cout << name << "," << strategies[static_cast<int>(searcher.get_strategy())] << ","
+                  << searcher.get_literals().required << "," << prefilter_ms / options.samples << ","
+                  << plain_ms / options.samples << "\n";
+    }
+}
+
+// Throughput of the batch matcher on many short inputs against a random DFA
+// whose table is far larger than the cache, by the number of lanes. Lanes 0
+// stands for plain CompiledDfa::accepts calls one after another.
+void benchmark_interleaved(const BenchmarkOptions &options) {
+    std::cout << "dfa_states,table_mb,lanes,inputs_per_ms\n";
+
+    RandomAutomatonConfig config;
+    config.alphabet = "abcdefghijklmnop";
+    config.state_count = 1 << 16;
+    config.density = 1.0;
+    config.final_probability = 0.5;
+
+    CompiledDfa dfa(RandomAutomatonGenerator(config, options.seed).generate());
+    double table_mb = static_cast<double>(dfa.get_transitions().size() * sizeof(uint32_t)) / (1 << 20);
+
+    RandomSource random(options.seed);
+    std::vector<std::string> words(1 << 18);
+    for (auto &word: words) {
+        word.resize(8 + random.next_index(57));
+        for (auto &c: word) {
+            c = random.next_char(config.alphabet);
+        }
+    }
+    std::vector<std::string_view> inputs(words.begin(), words.end());
+    std::vector<uint8_t> results(inputs.size());
+
+    for (size_t lanes: {0, 1, 4, 8, 12, 16}) {
+        double ms = 0;
+        for (size_t sample = 0; sample < options.samples; sample++) {
+            if (lanes == 0) {
+                ms += measure_ms([&] {
+                    for (size_t i = 0; i < inputs.size(); i++) {
+                        results[i] = dfa.accepts(inputs[i]);
+                    }
+                });
+            } else {
+                ms += measure_ms([&] { InterleavedDfaMatcher(dfa, lanes).accepts(inputs, results.data()); });
+            }
+        }
+
+        std::cout << dfa.get_state_count() << "," << table_mb << "," << lanes << ","
+                  << static_cast<double>(inputs.size() * options.samples) / ms << "\n";
+    }
+}
+
+// Time to run a DFA over one large buffer, sequentially and split between
+// the threads, for a DFA which gets its chunk maps from all the states and
+// one which is too large for that and guesses the incoming states
+void benchmark_parallel_scan(const BenchmarkOptions &options) {
+    std::cout << "dfa_states,threads,full_maps,mispredictions,sequential_ms,parallel_ms\n";
+
+    RandomSource random(options.seed);
+    std::string text(64 << 20, ' ');
+    for (auto &c: text) {
+        c = static_cast<char>('a' + random.next_index(4));
+    }
+
+    for (size_t state_count: {16, 4096}) {
+        RandomAutomatonConfig config;
+        config.alphabet = "abcd";
+        config.state_count = state_count;
+        config.density = 1.0;
+        config.final_probability = 0.5;
+
+        CompiledDfa dfa(RandomAutomatonGenerator(config, options.seed).generate());
+
+        for (size_t threads: {2, 4, 8}) {
+            ThreadPool pool(threads);
+            ParallelDfaMatcher matcher(dfa, pool);
+            ParallelDfaMatchStats stats;
+
+            uint32_t expected = 0, found = 0;
+            double sequential_ms = 0, parallel_ms = 0;
+            for (size_t sample = 0; sample < options.samples; sample++) {
+                sequential_ms += measure_ms([&] { expected = dfa.run(dfa.get_start_state(), text); });
+                parallel_ms += measure_ms([&] { found = matcher.run(text, &stats); });
+            }
+            assert(found == expected);
+
+            std::cout << dfa.get_state_count() << "," << threads << "," << stats.used_full_maps << ","
+                      << stats.mispredictions << "," << sequential_ms / options.samples << ","
+                      << parallel_ms / options.samples << "\n";
+        }
+    }
+}
+
+// Time to classify many short inputs: FiniteAutomaton::accepts one after
+// another, and the batch matcher simulating the same NFA and running its
+// compiled DFA, by the number of threads
+void benchmark_batch(const BenchmarkOptions &options) {
+    std::cout << "threads,inputs,plain_ms,nfa_ms,dfa_ms\n";
+
+    Regex regex = *("ab"_r + "c"_r + "ba"_r) * "a"_r * *("b"_r + "c"_r) * "a"_r;
+    FiniteAutomaton automaton(regex);
+    AutomatonSimplifier(automaton).simplify();
+    CompiledDfa dfa(PatternCompiler(regex).compile().get_dfa());
+
+    RandomSource random(options.seed);
+    std::vector<std::string> words(1 << 18);
+    for (auto &word: words) {
+        word.resize(4 + random.next_index(29));
+        for (auto &c: word) {
+            c = random.next_char("abc");
+        }
+    }
+    std::vector<std::string_view> inputs(words.begin(), words.end());
+
+    double plain_ms = 0;
+    size_t plain_count = 0;
+    for (size_t sample = 0; sample < options.samples; sample++) {
+        plain_ms += measure_ms([&] {
+            plain_count = 0;
+            for (auto input: inputs) {
+                plain_count += automaton.accepts(input);
+            }
+        });
+    }
+
+    for (size_t threads: {1, 2, 4, 8}) {
+        ThreadPool pool(threads);
+        BatchMatcher nfa_matcher(automaton, pool);
+        BatchMatcher dfa_matcher(dfa, pool);
+
+        double nfa_ms = 0, dfa_ms = 0;
+        size_t nfa_count = 0, dfa_count = 0;
+        for (size_t sample = 0; sample < options.samples; sample++) {
+            nfa_ms += measure_ms([&] { nfa_count = nfa_matcher.accepts(inputs).count(); });
+            dfa_ms += measure_ms([&] { dfa_count = dfa_matcher.accepts(inputs).count(); });
+        }
+        assert(nfa_count == plain_count && dfa_count == plain_count);
+
+        std::cout << threads << "," << inputs.size() << "," << plain_ms / options.samples << ","
+                  << nfa_ms / options.samples << "," << dfa_ms / options.samples << "\n";
+    }
+}
+
+// The whole argument has to be the number
+template<typename T>
+static bool parse_number(std::string_view text, T &value) {
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc() && end == text.data() + text.size();
+}
+
+int main(int argc, char **argv) {
+    std::map<std::string, std::function<void(const BenchmarkOptions &)>> modes = {
+            {"regex-scaling",     benchmark_regex_scaling},
+            {"automaton-scaling", benchmark_automaton_scaling},
+            {"front-ends",        benchmark_front_ends},
+            {"parallel-minify",   benchmark_parallel_minify},
+            {"minimize-paths",    benchmark_minimize_paths},
+            {"jit",               benchmark_jit},
+            {"prefilter",         benchmark_prefilter},
+            {"interleaved",       benchmark_interleaved},
+            {"parallel-scan",     benchmark_parallel_scan},
+            {"batch",             benchmark_batch},
+    };
+
+    BenchmarkOptions options;
+    std::string mode = "regex-scaling";
+    const char *usage = "Usage: formal_languages_benchmark [--seed N] [--samples N] [MODE]\n";
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            if (!parse_number(argv[++i], options.seed)) {
+                std::cerr << "Invalid seed: " << argv[i] << "\n" << usage;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            // The times are averaged over the samples
+            if (!parse_number(argv[++i], options.samples) || options.samples == 0) {
+                std::cerr << "Invalid number of samples: " << argv[i] << "\n" << usage;
+                return 1;
+            }
+        } else {
+            mode = argv[i];
+        }
+    }
+
+    auto it = modes.find(mode);
+    if (it == modes.end()) {
+        std::cerr << "Unknown benchmark mode: " << mode << "\n";
+        std::cerr << "Available modes:";
+        for (auto &[name, function]: modes) {
+            std::cerr << " " << name;
+        }
+        std::cerr << "\n";
+        return 1;
+    }
+
+    it->second(options);
+    return 0;
+}
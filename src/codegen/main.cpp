@@ -0,0 +1,90 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "../engine/regex-parser.hpp"
+#include "../engine/glushkov-automaton-builder.hpp"
+#include "../engine/automaton-determinator.hpp"
+#include "../engine/automaton-optimizer.hpp"
+#include "../engine/automaton-minifier.hpp"
+#include "../engine/automaton-cpp-printer.hpp"
+
+// Compiles a regex into a C++ header with a matcher function.
+// Usage: formal_languages_codegen --name NAME [--style switch|table] [--output FILE] REGEX
+// The regex is in the format it's printed in, like "a((b + c))*".
+
+static bool is_identifier(const std::string &name) {
+    if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0]))) {
+        return false;
+    }
+    for (char c: name) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int usage() {
+    std::cerr << "Usage: formal_languages_codegen --name NAME [--style switch|table] [--output FILE] REGEX\n";
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    std::string name;
+    std::string output;
+    std::string pattern;
+    bool has_pattern = false;
+    AutomatonCppStyle style = AutomatonCppStyle::Switch;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+            name = argv[++i];
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "--style") == 0 && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (value == "switch") {
+                style = AutomatonCppStyle::Switch;
+            } else if (value == "table") {
+                style = AutomatonCppStyle::Table;
+            } else {
+                std::cerr << "Unknown style: " << value << "\n";
+                return usage();
+            }
+        } else if (!has_pattern) {
+            pattern = argv[i];
+            has_pattern = true;
+        } else {
+            return usage();
+        }
+    }
+
+    if (!has_pattern || !is_identifier(name)) {
+        return usage();
+    }
+
+    RegexParser parser(pattern);
+    std::optional<Regex> regex = parser.parse();
+    if (!regex) {
+        std::cerr << "Invalid regex \"" << pattern << "\": " << parser.get_error() << "\n";
+        return 1;
+    }
+
+    FiniteAutomaton automaton = GlushkovAutomatonBuilder(*regex).build();
+    automaton = AutomatonDeterminator(automaton).determine();
+    AutomatonOptimizer(automaton).trim();
+    automaton = AutomatonMinifier(automaton).minify();
+
+    if (output.empty()) {
+        std::cout << AutomatonCppPrinter(automaton, name, style);
+        return 0;
+    }
+
+    std::ofstream stream(output);
+    if (!stream) {
+        std::cerr << "Cannot write to " << output << "\n";
+        return 1;
+    }
+    stream << AutomatonCppPrinter(automaton, name, style);
+    return 0;
+}
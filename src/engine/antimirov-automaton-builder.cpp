@@ -0,0 +1 @@
+#include "antimirov-automaton-builder.hpp"
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <unordered_map>
+#include "finite-automaton.hpp"
+#include "regex-derivative.hpp"
+
+// Builds the partial derivative (Antimirov) automaton of a regex. States are
+// the terms of partial derivatives, a state is final when its term is
+// nullable. The automaton is simple, has no epsilon-transitions and is never
+// larger than the position automaton, often noticeably smaller.
+
+class AntimirovAutomatonBuilder {
+public:
+    AntimirovAutomatonBuilder(const Regex &regex, const std::set<char> &alphabet = {}) :
+            regex(regex), alphabet(alphabet) {
+        regex.fill_alphabet(this->alphabet);
+    }
+
+    FiniteAutomaton build() {
+        FiniteAutomaton result;
+        result.extend_alphabet(alphabet);
+
+        std::vector<Regex> states;
+        std::unordered_map<Regex, size_t, RegexHash> state_indices;
+
+        auto find_or_add_state = [&](Regex &&term) {
+            auto it = state_indices.find(term);
+            if (it != state_indices.end()) {
+                return it->second;
+            }
+
+            size_t index = result.add_state(RegexDerivative::is_nullable(term));
+            state_indices.emplace(term, index);
+            states.push_back(std::move(term));
+            return index;
+        };
+
+        find_or_add_state(RegexDerivative::normalize(regex));
+
+        for (size_t state = 0; state < states.size(); state++) {
+            for (char c: alphabet) {
+                for (auto &term: RegexDerivative::derive_partial(states[state], c)) {
+                    size_t target = find_or_add_state(std::move(term));
+                    result.add_transition(state, target, Regex(CharRegex(c)));
+                }
+            }
+        }
+
+        return result;
+    }
+
+    const Regex &regex;
+    std::set<char> alphabet;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "finite-automaton.hpp"
+#include "pipeline-control.hpp"
 
 struct DoubleTransition {
     size_t state_1_index;
@@ -14,7 +15,8 @@ struct DoubleTransition {
 
 class AutomatonCollapser {
 public:
-    AutomatonCollapser(FiniteAutomaton &automaton) : automaton(automaton) {
+    AutomatonCollapser(FiniteAutomaton &automaton, PipelineControl *control = nullptr) :
+            automaton(automaton), control(control) {
 
     }
 
@@ -181,11 +183,28 @@ public:
             while(collapse_multiple_edges(i));
         }
 
+        // All the states but the start and the final one get collapsed
+        size_t done = 0;
+        size_t total = automaton.get_states().size();
+
         size_t state = -1;
         while ((state = pick_state_to_collapse()) != -1) {
+            if (control) {
+                if (control->should_stop()) {
+                    return;
+                }
+                control->report_progress("collapse", done, total > done + 2 ? total - done - 2 : 1);
+            }
+
             collapse_state(state);
+            done++;
+        }
+
+        if (control) {
+            control->report_progress("collapse", done, 0);
         }
     }
 
     FiniteAutomaton &automaton;
+    PipelineControl *control;
 };
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include <cctype>
+#include <map>
+#include "automaton-cpp-printer.hpp"
+#include "compiled-dfa.hpp"
+
+static void print_switch(std::ostream &stream, const AutomatonCppPrinter &printer) {
+    auto &states = printer.automaton.get_states();
+
+    stream << "inline bool " << printer.function_name << "(std::string_view input) {\n";
+    stream << "    auto position = reinterpret_cast<const unsigned char *>(input.data());\n";
+    stream << "    auto end = position + input.size();\n\n";
+    stream << "    goto state_" << printer.automaton.get_start_state_index() << ";\n";
+
+    for (size_t i = 0; i < states.size(); i++) {
+        // Bytes leading to the same state share a single goto
+        std::map<size_t, std::vector<unsigned char>> targets;
+        for (auto &transition: states[i].transitions) {
+            targets[transition.target_index].push_back(CharRegex::get_char(transition.regex));
+        }
+
+        stream << "\nstate_" << i << ":\n";
+        stream << "    if (position == end) return " << (states[i].is_final ? "true" : "false") << ";\n";
+
+        if (targets.empty()) {
+            stream << "    return false;\n";
+            continue;
+        }
+
+        stream << "    switch (*position++) {\n";
+        for (auto &[target, bytes]: targets) {
+            for (unsigned char byte: bytes) {
+                stream << "        case " << static_cast<unsigned>(byte) << ":";
+                if (std::isgraph(byte) && byte != '\\') {
+                    stream << " // '" << byte << "'";
+                }
+                stream << "\n";
+            }
+            stream << "            goto state_" << target << ";\n";
+        }
+        stream << "        default:\n";
+        stream << "            return false;\n";
+        stream << "    }\n";
+    }
+
+    stream << "}\n";
+}
+
+static void print_table(std::ostream &stream, const AutomatonCppPrinter &printer) {
+    CompiledDfa dfa(printer.automaton);
+
+    std::string state_type = "uint32_t";
+    if (dfa.get_state_count() <= UINT8_MAX + 1) {
+        state_type = "uint8_t";
+    } else if (dfa.get_state_count() <= UINT16_MAX + 1) {
+        state_type = "uint16_t";
+    }
+
+    stream << "inline bool " << printer.function_name << "(std::string_view input) {\n";
+
+    stream << "    static constexpr uint8_t byte_classes[256] = {";
+    for (size_t byte = 0; byte < 256; byte++) {
+        stream << (byte % 16 == 0 ? "\n            " : " ") << static_cast<unsigned>(dfa.get_byte_class(byte)) << ",";
+    }
+    stream << "\n    };\n\n";
+
+    // State 0 is the dead state
+    stream << "    static constexpr " << state_type << " transitions[" << dfa.get_state_count() << "]["
+           << dfa.get_class_count() << "] = {\n";
+    for (size_t state = 0; state < dfa.get_state_count(); state++) {
+        stream << "            {";
+        for (size_t cls = 0; cls < dfa.get_class_count(); cls++) {
+            stream << (cls == 0 ? "" : ", ") << dfa.get_transitions()[state * dfa.get_class_count() + cls];
+        }
+        stream << "},\n";
+    }
+    stream << "    };\n\n";
+
+    stream << "    static constexpr bool finals[" << dfa.get_state_count() << "] = {";
+    for (size_t state = 0; state < dfa.get_state_count(); state++) {
+        stream << (state == 0 ? "" : ", ") << (dfa.is_final(state) ? "true" : "false");
+    }
+    stream << "};\n\n";
+
+    stream << "    " << state_type << " state = " << dfa.get_start_state() << ";\n";
+    stream << "    for (unsigned char byte: input) {\n";
+    stream << "        state = transitions[state][byte_classes[byte]];\n";
+    stream << "        if (state == 0) return false;\n";
+    stream << "    }\n";
+    stream << "    return finals[state];\n";
+    stream << "}\n";
+}
+
+std::ostream &operator<<(std::ostream &stream, const AutomatonCppPrinter &printer) {
+    assert(printer.automaton.is_simple());
+    assert(printer.automaton.is_deterministic());
+    assert(!printer.automaton.has_epsilon_transitions());
+
+    stream << "// Generated from a DFA with " << printer.automaton.get_states().size()
+           << " states, do not edit\n\n";
+    stream << "#pragma once\n\n";
+    if (printer.style == AutomatonCppStyle::Table) {
+        stream << "#include <cstdint>\n";
+    }
+    stream << "#include <string_view>\n\n";
+
+    switch (printer.style) {
+        case AutomatonCppStyle::Switch:
+            print_switch(stream, printer);
+            break;
+        case AutomatonCppStyle::Table:
+            print_table(stream, printer);
+            break;
+    }
+
+    return stream;
+}
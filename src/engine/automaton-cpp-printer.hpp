@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include "finite-automaton.hpp"
+
+enum class AutomatonCppStyle {
+    // Every state is a label with a switch over the next byte jumping to the next label
+    Switch,
+    // A byte class map and a transition table, both static constexpr
+    Table
+};
+
+// Prints a DFA as a standalone C++ header with a single function
+// `bool <function_name>(std::string_view input)`, which tells whether the
+// automaton accepts the input. The generated code depends on nothing but the
+// standard library. Missing transitions reject the input right away.
+
+struct AutomatonCppPrinter {
+    AutomatonCppPrinter(const FiniteAutomaton &automaton, std::string function_name,
+                        AutomatonCppStyle style = AutomatonCppStyle::Switch) :
+            automaton(automaton), function_name(std::move(function_name)), style(style) {}
+
+    const FiniteAutomaton &automaton;
+    std::string function_name;
+    AutomatonCppStyle style;
+};
+
+std::ostream &operator<<(std::ostream &stream, const AutomatonCppPrinter &printer);
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <climits>
+#include <cstdint>
+#include <optional>
 #include <vector>
 #include <unordered_set>
 #include <unordered_map>
 #include "finite-automaton.hpp"
 #include "automaton-completer.hpp"
+#include "pipeline-control.hpp"
 
 struct StateSuperposition {
     std::set<size_t> states;
@@ -53,10 +57,22 @@ struct StateBoundSuperposition {
     }
 };
 
-// Creates DFA from simplified complete FA w/o epsilon-transitions.
+// Caps on the size of the DFA under construction. The byte count is an
+// estimate of the memory held by the found superpositions and transitions.
+struct DeterminizationLimits {
+    size_t max_states = SIZE_MAX;
+    size_t max_transitions = SIZE_MAX;
+    size_t max_bytes = SIZE_MAX;
+};
+
+// Creates DFA from simplified FA w/o epsilon-transitions. The input doesn't
+// have to be complete: missing transitions lead to an implicit dead state,
+// which never shows up among the superpositions, so the result is partial.
 
 struct AutomatonDeterminator {
-    AutomatonDeterminator(const FiniteAutomaton &automaton) : automaton(automaton) {}
+    AutomatonDeterminator(const FiniteAutomaton &automaton, const DeterminizationLimits &limits = {},
+                          PipelineControl *control = nullptr) :
+            automaton(automaton), limits(limits), control(control) {}
 
     void add_state_bound_superpositions() {
         auto &transitions = state_bound_superposition.transitions;
@@ -79,6 +95,23 @@ struct AutomatonDeterminator {
         bool changed = false;
 
         for (auto &state_superposition: found_superpositions) {
+            // Every superposition only needs to be expanded once
+            if (state_superposition.id < expanded.size() && expanded[state_superposition.id]) {
+                continue;
+            }
+            if (state_superposition.id >= expanded.size()) {
+                expanded.resize(state_superposition.id + 1, false);
+            }
+            expanded[state_superposition.id] = true;
+
+            if (control) {
+                if (control->should_stop()) {
+                    return false;
+                }
+                control->report_progress("determine", expanded_count, found_superpositions.size() - expanded_count);
+                expanded_count++;
+            }
+
             for (auto &state_index: state_superposition.states) {
                 state_bound_superposition.transitions.clear();
 
@@ -105,30 +138,88 @@ struct AutomatonDeterminator {
                     StateSuperposition new_superposition = superposition;
                     new_superposition.id = found_superpositions.size();
                     found_transitions.push_back({state_superposition.id, new_superposition.id, ch});
+                    estimated_bytes += estimate_superposition_bytes(new_superposition);
                     found_superpositions.insert(std::move(new_superposition));
                     changed = true;
                 } else {
                     found_transitions.push_back({state_superposition.id, it->id, ch});
                 }
+                estimated_bytes += sizeof(SuperpositionTransition);
             }
 
             next_superpositions.clear();
+
+            if (is_limit_exceeded()) {
+                limit_exceeded = true;
+                return false;
+            }
         }
 
         return changed;
     }
 
+    // Returns nothing when the DFA outgrows the limits or the pipeline is
+    // stopped. The construction ends as soon as that happens.
+    std::optional<FiniteAutomaton> try_determine() {
+        FiniteAutomaton result = determine();
+        if (limit_exceeded || is_stopped()) {
+            return std::nullopt;
+        }
+        return result;
+    }
+
+    // Runs the automaton from all the given states at once, instead of its start state
+    void set_start_states(const std::vector<size_t> &states) {
+        start_states = states;
+    }
+
+    bool is_stopped() const {
+        return control && control->is_stopped();
+    }
+
+    bool is_limit_exceeded() const {
+        return found_superpositions.size() > limits.max_states ||
+               found_transitions.size() > limits.max_transitions ||
+               estimated_bytes > limits.max_bytes;
+    }
+
+    static size_t estimate_superposition_bytes(const StateSuperposition &superposition) {
+        // Every element of std::set is a separately allocated tree node
+        return sizeof(StateSuperposition) + 4 * sizeof(void *) +
+               superposition.states.size() * (sizeof(size_t) + 4 * sizeof(void *));
+    }
+
+    // Returns the empty language, a single non-final state, when the DFA
+    // outgrows the limits or the pipeline is stopped
     FiniteAutomaton determine() {
         assert(!automaton.has_epsilon_transitions());
-        assert(automaton.is_complete());
 
-        StateSuperposition start_superposition = {{automaton.get_start_state_index()}};
-        start_superposition.is_final = automaton.get_states()[automaton.get_start_state_index()].is_final;
+        StateSuperposition start_superposition;
+        if (start_states.empty()) {
+            start_superposition.states = {automaton.get_start_state_index()};
+        } else {
+            start_superposition.states.insert(start_states.begin(), start_states.end());
+        }
+        for (size_t state: start_superposition.states) {
+            start_superposition.is_final = start_superposition.is_final || automaton.get_states()[state].is_final;
+        }
+        estimated_bytes = estimate_superposition_bytes(start_superposition);
         found_superpositions = {std::move(start_superposition)};
 
         while (find_new_superpositions());
 
+        if (limit_exceeded || is_stopped()) {
+            return FiniteAutomaton::empty_language(automaton.alphabet);
+        }
+
         FiniteAutomaton new_automaton;
+        new_automaton.set_unique_transitions(true);
+        // Letters without transitions still matter for the completion and the inversion
+        new_automaton.extend_alphabet(automaton.alphabet);
+
+        if (control) {
+            control->report_progress("determine", expanded_count, 0);
+        }
 
         for (int i = 0; i < found_superpositions.size(); i++) {
             new_automaton.add_state(false);
@@ -141,19 +232,27 @@ struct AutomatonDeterminator {
         }
 
         for (auto &transition: found_transitions) {
-            if (new_automaton.find_transition(transition.ch, transition.source_index, transition.target_index) == -1) {
-                new_automaton.add_transition(transition.source_index, transition.target_index,
-                                             Regex(CharRegex(transition.ch)));
-            }
+            new_automaton.add_transition(transition.source_index, transition.target_index,
+                                         Regex(CharRegex(transition.ch)));
         }
 
+        // The adjacency stays sorted, but the later stages may add transitions freely
+        new_automaton.set_unique_transitions(false);
+
         return new_automaton;
     }
 
     const FiniteAutomaton &automaton;
+    DeterminizationLimits limits;
+    PipelineControl *control;
+    bool limit_exceeded = false;
 
 private:
+    std::vector<size_t> start_states;
     std::set<StateSuperposition> found_superpositions;
+    std::vector<bool> expanded;
+    size_t expanded_count = 0;
+    size_t estimated_bytes = 0;
     std::vector<SuperpositionTransition> found_transitions;
 
     std::unordered_map<char, StateSuperposition> next_superpositions;
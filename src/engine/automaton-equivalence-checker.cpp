@@ -0,0 +1 @@
+#include "automaton-equivalence-checker.hpp"
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include "finite-automaton.hpp"
+
+// Checks whether two DFAs accept the same language with the Hopcroft-Karp
+// algorithm: both automata are walked together breadth-first, and the states
+// which are assumed to be equivalent are joined in a union-find structure.
+// Missing transitions lead to an implicit dead state, so partial DFAs are fine.
+// The first counterexample found is a shortest word accepted by exactly one
+// of the automata.
+
+class AutomatonEquivalenceChecker {
+public:
+    AutomatonEquivalenceChecker(const FiniteAutomaton &left, const FiniteAutomaton &right) : left(left), right(right) {
+        assert(left.is_deterministic());
+        assert(right.is_deterministic());
+    }
+
+    bool are_equivalent() {
+        return !find_counterexample().has_value();
+    }
+
+    std::optional<std::string> find_counterexample() {
+        prepare();
+
+        size_t left_start = left.get_start_state_index();
+        size_t right_start = left_state_count + right.get_start_state_index();
+
+        if (is_final[left_start] != is_final[right_start]) {
+            return "";
+        }
+
+        std::vector<PairNode> queue = {{left_start, right_start, 0, 0}};
+        unite(left_start, right_start);
+
+        for (size_t position = 0; position < queue.size(); position++) {
+            for (size_t letter = 0; letter < letters.size(); letter++) {
+                size_t left_target = get_target(queue[position].left, letter);
+                size_t right_target = get_target(queue[position].right, letter);
+
+                if (find(left_target) == find(right_target)) {
+                    continue;
+                }
+
+                queue.push_back({left_target, right_target, position, letters[letter]});
+
+                if (is_final[left_target] != is_final[right_target]) {
+                    return restore_word(queue, queue.size() - 1);
+                }
+
+                unite(left_target, right_target);
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    const FiniteAutomaton &left;
+    const FiniteAutomaton &right;
+
+private:
+    struct PairNode {
+        size_t left;
+        size_t right;
+        size_t parent;
+        char letter;
+    };
+
+    // Both automata share the node numbering: left states go first,
+    // then the right ones, and the dead state is the last node.
+    void prepare() {
+        left_state_count = left.get_states().size();
+        size_t right_state_count = right.get_states().size();
+        dead_state = left_state_count + right_state_count;
+
+        std::set<char> alphabet = left.alphabet;
+        alphabet.insert(right.alphabet.begin(), right.alphabet.end());
+        letters.assign(alphabet.begin(), alphabet.end());
+
+        letter_indices.fill(-1);
+        for (size_t i = 0; i < letters.size(); i++) {
+            letter_indices[static_cast<unsigned char>(letters[i])] = static_cast<int>(i);
+        }
+
+        size_t node_count = dead_state + 1;
+        targets.assign(node_count * letters.size(), dead_state);
+        is_final.assign(node_count, false);
+
+        fill_targets(left, 0);
+        fill_targets(right, left_state_count);
+
+        parents.resize(node_count);
+        ranks.assign(node_count, 0);
+        for (size_t i = 0; i < node_count; i++) {
+            parents[i] = i;
+        }
+    }
+
+    void fill_targets(const FiniteAutomaton &automaton, size_t offset) {
+        auto &states = automaton.get_states();
+
+        for (size_t i = 0; i < states.size(); i++) {
+            is_final[offset + i] = states[i].is_final;
+
+            for (auto &transition: states[i].transitions) {
+                int letter = letter_indices[static_cast<unsigned char>(CharRegex::get_char(transition.regex))];
+                targets[(offset + i) * letters.size() + letter] = offset + transition.target_index;
+            }
+        }
+    }
+
+    size_t get_target(size_t node, size_t letter) const {
+        return targets[node * letters.size() + letter];
+    }
+
+    size_t find(size_t node) {
+        while (parents[node] != node) {
+            parents[node] = parents[parents[node]];
+            node = parents[node];
+        }
+        return node;
+    }
+
+    void unite(size_t a, size_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return;
+        if (ranks[a] < ranks[b]) std::swap(a, b);
+        parents[b] = a;
+        if (ranks[a] == ranks[b]) ranks[a]++;
+    }
+
+    static std::string restore_word(const std::vector<PairNode> &queue, size_t index) {
+        std::string word;
+        while (index != 0) {
+            word.push_back(queue[index].letter);
+            index = queue[index].parent;
+        }
+        std::reverse(word.begin(), word.end());
+        return word;
+    }
+
+    size_t left_state_count = 0;
+    size_t dead_state = 0;
+
+    std::vector<char> letters;
+    std::array<int, 256> letter_indices{};
+
+    std::vector<size_t> targets;
+    std::vector<bool> is_final;
+
+    std::vector<size_t> parents;
+    std::vector<size_t> ranks;
+};
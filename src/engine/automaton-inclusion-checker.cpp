@@ -0,0 +1 @@
+#include "automaton-inclusion-checker.hpp"
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include "finite-automaton.hpp"
+
+struct InclusionCheckerNode {
+    size_t left_state;
+    // Sorted set of right states, only the maximal ones with respect to the simulation
+    std::vector<size_t> right_states;
+    size_t parent;
+    char letter;
+};
+
+// Checks L(left) ⊆ L(right) on simple FA w/o epsilon-transitions without
+// determinizing the right automaton. Pairs (left state, set of right states)
+// are explored breadth-first, and a pair is dropped when it is subsumed by an
+// already explored pair: same left state and a set of right states every
+// member of which is simulated by some member of the new set. The maximal
+// forward simulation on the right automaton is computed beforehand, by
+// counter-based refinement.
+
+class AutomatonInclusionChecker {
+public:
+    AutomatonInclusionChecker(const FiniteAutomaton &left, const FiniteAutomaton &right, bool use_simulation = true) :
+            left(left), right(right), use_simulation(use_simulation) {
+        assert(left.is_simple() && !left.has_epsilon_transitions());
+        assert(right.is_simple() && !right.has_epsilon_transitions());
+    }
+
+    bool is_included() {
+        return !find_counterexample().has_value();
+    }
+
+    // Returns a word accepted by the left automaton, but not by the right one
+    std::optional<std::string> find_counterexample() {
+        prepare();
+
+        std::vector<InclusionCheckerNode> queue;
+        antichains.assign(left.get_states().size(), {});
+
+        try_add_node(queue, left.get_start_state_index(), {right.get_start_state_index()}, 0, '\0');
+
+        for (size_t position = 0; position < queue.size(); position++) {
+            if (is_subsumed_later(queue, position)) {
+                continue;
+            }
+
+            if (is_rejecting(queue[position])) {
+                return restore_word(queue, position);
+            }
+
+            size_t left_state = queue[position].left_state;
+
+            for (size_t letter = 0; letter < letters.size(); letter++) {
+                std::vector<size_t> right_targets;
+                for (size_t right_state: queue[position].right_states) {
+                    auto &targets = right_transitions[right_state * letters.size() + letter];
+                    right_targets.insert(right_targets.end(), targets.begin(), targets.end());
+                }
+                reduce(right_targets);
+
+                for (size_t left_target: left_transitions[left_state * letters.size() + letter]) {
+                    try_add_node(queue, left_target, right_targets, position, letters[letter]);
+                }
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    const FiniteAutomaton &left;
+    const FiniteAutomaton &right;
+    bool use_simulation;
+
+private:
+    bool is_rejecting(const InclusionCheckerNode &node) const {
+        if (!left.get_states()[node.left_state].is_final) {
+            return false;
+        }
+        for (size_t right_state: node.right_states) {
+            if (right.get_states()[right_state].is_final) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Whether the right states of the first set are all simulated by the second set
+    bool is_covered(const std::vector<size_t> &smaller, const std::vector<size_t> &larger) const {
+        for (size_t state: smaller) {
+            bool covered = false;
+            for (size_t other: larger) {
+                if (is_simulated(state, other)) {
+                    covered = true;
+                    break;
+                }
+            }
+            if (!covered) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool is_simulated(size_t state, size_t by) const {
+        return simulation[state * right.get_states().size() + by];
+    }
+
+    // Adds the node unless it's subsumed by a node which is already in the antichain.
+    // The nodes subsumed by the new one are removed from the antichain.
+    void try_add_node(std::vector<InclusionCheckerNode> &queue, size_t left_state, const std::vector<size_t> &right_states,
+                      size_t parent, char letter) {
+        auto &antichain = antichains[left_state];
+
+        for (size_t index: antichain) {
+            if (is_covered(queue[index].right_states, right_states)) {
+                return;
+            }
+        }
+
+        std::erase_if(antichain, [&](size_t index) {
+            return is_covered(right_states, queue[index].right_states);
+        });
+
+        antichain.push_back(queue.size());
+        queue.push_back({left_state, right_states, parent, letter});
+    }
+
+    // Nodes removed from the antichain after they were queued need no exploration
+    bool is_subsumed_later(const std::vector<InclusionCheckerNode> &queue, size_t position) const {
+        auto &antichain = antichains[queue[position].left_state];
+        return std::find(antichain.begin(), antichain.end(), position) == antichain.end();
+    }
+
+    // Removes duplicates and the states simulated by other states of the set
+    void reduce(std::vector<size_t> &states) const {
+        std::sort(states.begin(), states.end());
+        states.erase(std::unique(states.begin(), states.end()), states.end());
+
+        if (!use_simulation) {
+            return;
+        }
+
+        std::vector<size_t> result;
+        for (size_t i = 0; i < states.size(); i++) {
+            bool dominated = false;
+            for (size_t j = 0; j < states.size(); j++) {
+                if (i == j || !is_simulated(states[i], states[j])) continue;
+                // Mutually simulating states are equivalent, keep the first of them
+                if (!is_simulated(states[j], states[i]) || j < i) {
+                    dominated = true;
+                    break;
+                }
+            }
+            if (!dominated) {
+                result.push_back(states[i]);
+            }
+        }
+        states = std::move(result);
+    }
+
+    void prepare() {
+        std::set<char> alphabet = left.alphabet;
+        alphabet.insert(right.alphabet.begin(), right.alphabet.end());
+        letters.assign(alphabet.begin(), alphabet.end());
+
+        left_transitions = get_transition_table(left);
+        right_transitions = get_transition_table(right);
+
+        compute_simulation();
+    }
+
+    std::vector<std::vector<size_t>> get_transition_table(const FiniteAutomaton &automaton) const {
+        std::vector<std::vector<size_t>> table(automaton.get_states().size() * letters.size());
+
+        for (size_t i = 0; i < automaton.get_states().size(); i++) {
+            for (auto &transition: automaton.get_states()[i].transitions) {
+                size_t letter = std::lower_bound(letters.begin(), letters.end(),
+                                                 CharRegex::get_char(transition.regex)) - letters.begin();
+                table[i * letters.size() + letter].push_back(transition.target_index);
+            }
+        }
+
+        return table;
+    }
+
+    // simulation[p * n + q] is true when q simulates p: q is final if p is,
+    // and every move of p can be answered by a move of q into a state which
+    // simulates the target of p. Without simulation only the identity is used.
+    //
+    // Refined by counting, as in Henzinger, Henzinger and Kopke: for every
+    // letter a, state p and state q, the a-successors of q which simulate p.
+    // A removed pair (p', q') only decrements the counters of the
+    // a-predecessors of q', and a counter of (p', q) which drops to zero
+    // removes the pairs of q with the a-predecessors of p'. Every pair is
+    // removed once, so the refinement takes O(|Σ|·n² + n·m) steps.
+    void compute_simulation() {
+        size_t state_count = right.get_states().size();
+        simulation.assign(state_count * state_count, false);
+
+        for (size_t p = 0; p < state_count; p++) {
+            for (size_t q = 0; q < state_count; q++) {
+                simulation[p * state_count + q] = use_simulation ?
+                        (!right.get_states()[p].is_final || right.get_states()[q].is_final) : p == q;
+            }
+        }
+
+        if (!use_simulation) {
+            return;
+        }
+
+        size_t letter_count = letters.size();
+        std::vector<std::vector<size_t>> predecessors(state_count * letter_count);
+        for (size_t q = 0; q < state_count; q++) {
+            for (size_t letter = 0; letter < letter_count; letter++) {
+                for (size_t target: right_transitions[q * letter_count + letter]) {
+                    predecessors[target * letter_count + letter].push_back(q);
+                }
+            }
+        }
+
+        // counters[(letter * n + p) * n + q]
+        std::vector<uint32_t> counters(letter_count * state_count * state_count, 0);
+        for (size_t q = 0; q < state_count; q++) {
+            for (size_t letter = 0; letter < letter_count; letter++) {
+                for (size_t q_target: right_transitions[q * letter_count + letter]) {
+                    for (size_t p = 0; p < state_count; p++) {
+                        if (simulation[p * state_count + q_target]) {
+                            counters[(letter * state_count + p) * state_count + q]++;
+                        }
+                    }
+                }
+            }
+        }
+
+        std::vector<std::pair<size_t, size_t>> removed;
+        auto remove_moves_to = [&](size_t letter, size_t p_target, size_t q) {
+            for (size_t p: predecessors[p_target * letter_count + letter]) {
+                if (simulation[p * state_count + q]) {
+                    simulation[p * state_count + q] = false;
+                    removed.emplace_back(p, q);
+                }
+            }
+        };
+
+        // The moves which no move of q answers even before the refinement
+        for (size_t letter = 0; letter < letter_count; letter++) {
+            for (size_t p_target = 0; p_target < state_count; p_target++) {
+                for (size_t q = 0; q < state_count; q++) {
+                    if (counters[(letter * state_count + p_target) * state_count + q] == 0) {
+                        remove_moves_to(letter, p_target, q);
+                    }
+                }
+            }
+        }
+
+        while (!removed.empty()) {
+            auto [p_target, q_target] = removed.back();
+            removed.pop_back();
+
+            for (size_t letter = 0; letter < letter_count; letter++) {
+                for (size_t q: predecessors[q_target * letter_count + letter]) {
+                    if (--counters[(letter * state_count + p_target) * state_count + q] == 0) {
+                        remove_moves_to(letter, p_target, q);
+                    }
+                }
+            }
+        }
+    }
+
+    static std::string restore_word(const std::vector<InclusionCheckerNode> &queue, size_t index) {
+        std::string word;
+        while (index != 0) {
+            word.push_back(queue[index].letter);
+            index = queue[index].parent;
+        }
+        std::reverse(word.begin(), word.end());
+        return word;
+    }
+
+    std::vector<char> letters;
+    std::vector<std::vector<size_t>> left_transitions;
+    std::vector<std::vector<size_t>> right_transitions;
+    std::vector<bool> simulation;
+
+    // Indices of the queue nodes forming the antichain, one for each left state
+    std::vector<std::vector<size_t>> antichains;
+};
+
+// Checks L(automaton) = Σ* over the alphabet of the automaton, as the inclusion
+// of the one-state universal automaton into the given one.
+
+class AutomatonUniversalityChecker {
+public:
+    AutomatonUniversalityChecker(const FiniteAutomaton &automaton, bool use_simulation = true) :
+            automaton(automaton), use_simulation(use_simulation) {}
+
+    bool is_universal() {
+        return !find_counterexample().has_value();
+    }
+
+    // Returns a word which is not accepted by the automaton
+    std::optional<std::string> find_counterexample() {
+        FiniteAutomaton universal;
+        universal.add_state(true);
+        for (char c: automaton.alphabet) {
+            universal.add_transition(0, 0, Regex(CharRegex(c)));
+        }
+
+        return AutomatonInclusionChecker(universal, automaton, use_simulation).find_counterexample();
+    }
+
+    const FiniteAutomaton &automaton;
+    bool use_simulation;
+};
@@ -1,12 +1,20 @@
 #pragma once
 
 #include "finite-automaton.hpp"
+#include "automaton-completer.hpp"
+
+// Inverts the language of a DFA. A partial DFA gets its dead state
+// materialized first, since the dead state becomes accepting.
 
 class AutomatonInverter {
 public:
     AutomatonInverter(FiniteAutomaton &automaton): automaton(automaton) {}
 
     void invert() {
+        assert(automaton.is_deterministic());
+
+        // Only adds the trap state if some transition is missing
+        AutomatonCompleter(automaton).complete();
 
         // Add all the transitions
         for (int state_index = 0; state_index < automaton.get_states().size(); state_index++) {
@@ -2,6 +2,7 @@
 
 #include <unordered_map>
 #include "finite-automaton.hpp"
+#include "pipeline-control.hpp"
 
 struct AutomatonMinifierTransition {
     char letter;
@@ -27,38 +28,66 @@ struct AutomatonMinifierEquivalenceClass {
     }
 };
 
+// Minimizes a DFA. Missing transitions lead to an implicit dead state, which
+// takes part in the refinement as an extra state, so the states which can
+// never accept are merged with it. For a partial automaton the dead class is
+// left implicit in the result, a complete automaton stays complete.
+
 class AutomatonMinifier {
 public:
-    AutomatonMinifier(FiniteAutomaton &automaton) : automaton(automaton) {
+    AutomatonMinifier(FiniteAutomaton &automaton, PipelineControl *control = nullptr) :
+            automaton(automaton), control(control) {
 
     }
 
     FiniteAutomaton minify() {
 
         size_t state_count = automaton.get_states().size();
+        int dead_state = static_cast<int>(state_count);
+        bool is_partial = false;
 
-        std::vector<int> new_class_indices(state_count);
-        std::vector<int> class_indices(state_count);
+        std::vector<int> new_class_indices(state_count + 1);
+        std::vector<int> class_indices(state_count + 1);
         std::map<AutomatonMinifierEquivalenceClass, std::set<int>> equiv_classes;
 
         for (int i = 0; i < state_count; i++) {
             class_indices[i] = automaton.get_states()[i].is_final ? 1 : 0;
         }
+        class_indices[dead_state] = 0;
+
+        size_t round = 0;
+
+        // Runs at least once, so that an automaton without final states is refined too
+        do {
+            if (control) {
+                if (control->should_stop()) {
+                    return FiniteAutomaton::empty_language(automaton.alphabet);
+                }
+                // Every round but the last one splits some class, which bounds the rounds left
+                round++;
+                control->report_progress("minify", round, state_count + 1 - equiv_classes.size());
+            }
 
-        while (class_indices != new_class_indices) {
             equiv_classes.clear();
             int max_class_index = 0;
 
-            for (int state = 0; state < automaton.get_states().size(); state++) {
+            for (int state = 0; state <= dead_state; state++) {
                 AutomatonMinifierEquivalenceClass eq_class{ class_indices[state] };
 
                 for (char letter : automaton.alphabet) {
-                    int transitionIndex = automaton.find_transition(letter, state);
-                    assert(transitionIndex != -1);
+                    int target = dead_state;
 
-                    int targetClass = class_indices[automaton.get_transition(state, transitionIndex).target_index];
+                    if (state != dead_state) {
+                        int transitionIndex = automaton.find_transition(letter, state);
 
-                    eq_class.transitions.push_back(AutomatonMinifierTransition { letter, targetClass });
+                        if (transitionIndex == -1) {
+                            is_partial = true;
+                        } else {
+                            target = static_cast<int>(automaton.get_transition(state, transitionIndex).target_index);
+                        }
+                    }
+
+                    eq_class.transitions.push_back(AutomatonMinifierTransition { letter, class_indices[target] });
                 }
 
                 equiv_classes[eq_class].insert(state);
@@ -73,29 +102,56 @@ public:
             }
 
             std::swap(class_indices, new_class_indices);
+        } while (class_indices != new_class_indices);
+
+        // The dead class is dropped unless it holds the start state, or the
+        // automaton is complete and some real states are equivalent to it
+        int dead_class = class_indices[dead_state];
+        int start_class = class_indices[automaton.get_start_state_index()];
+        bool drop_dead_class = dead_class != start_class;
+
+        if (!is_partial) {
+            for (auto& [eq_class, states] : equiv_classes) {
+                if (eq_class.class_index == dead_class && states.size() > 1) {
+                    drop_dead_class = false;
+                }
+            }
+        }
+
+        if (control) {
+            control->report_progress("minify", round, 0);
         }
 
         FiniteAutomaton result;
         result.extend_alphabet(automaton.alphabet);
 
-        std::vector<size_t> result_nodes(equiv_classes.size());
-        for (auto& cls_node : result_nodes) {
-            cls_node = result.add_state(false);
+        std::vector<int> result_nodes(equiv_classes.size(), -1);
+        for (int cls = 0; cls < result_nodes.size(); cls++) {
+            if (!drop_dead_class || cls != dead_class) {
+                result_nodes[cls] = static_cast<int>(result.add_state(false));
+            }
         }
 
         for (auto& [eq_class, states] : equiv_classes) {
+            int node = result_nodes[eq_class.class_index];
+            if (node == -1) continue;
+
             for (int old_state : states) {
+                if (old_state == dead_state) continue;
+
                 if (automaton.get_states()[old_state].is_final) {
-                    result.make_state_final(eq_class.class_index, true);
+                    result.make_state_final(node, true);
                 }
 
                 if (automaton.get_start_state_index() == old_state) {
-                    result.set_start_state(eq_class.class_index);
+                    result.set_start_state(node);
                 }
             }
 
             for (auto& transition : eq_class.transitions) {
-                result.add_transition(eq_class.class_index, transition.target, Regex(CharRegex(transition.letter)));
+                if (is_partial && transition.target == dead_class) continue;
+
+                result.add_transition(node, result_nodes[transition.target], Regex(CharRegex(transition.letter)));
             }
         }
 
@@ -103,4 +159,5 @@ public:
     }
 
     FiniteAutomaton &automaton;
-};
\ No newline at end of file
+    PipelineControl *control;
+};
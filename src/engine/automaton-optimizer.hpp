@@ -2,7 +2,11 @@
 
 #include "finite-automaton.hpp"
 
-// Optimizes the automaton by removing unreachable states and deleting zero-transitions
+// Optimizes the automaton by deleting zero-transitions and trimming it: the
+// states which are unreachable from the start state, or from which no final
+// state can be reached, don't change the language and are removed. Trimming
+// is linear in the size of the automaton, so it's cheap enough to run between
+// all the stages of the pipeline.
 
 class AutomatonOptimizer {
 public:
@@ -27,21 +31,18 @@ public:
         }
     }
 
-    void remove_unreachable_states() {
-        // Mark all states as unreachable
-        std::vector<bool> reachable(automaton.get_states().size(), false);
+    std::vector<bool> find_reachable_states() const {
+        auto &states = automaton.get_states();
+        std::vector<bool> reachable(states.size(), false);
 
-        // Mark the initial state as reachable
         reachable[automaton.get_start_state_index()] = true;
-
-        // Mark all states that can be reached from the initial state as reachable
         std::vector<size_t> current_states = {automaton.get_start_state_index()};
 
-        while(!current_states.empty()) {
+        while (!current_states.empty()) {
             size_t state_index = current_states.back();
             current_states.pop_back();
 
-            for (auto &transition: automaton.get_states()[state_index].transitions) {
+            for (auto &transition: states[state_index].transitions) {
                 if (!reachable[transition.target_index]) {
                     reachable[transition.target_index] = true;
                     current_states.push_back(transition.target_index);
@@ -49,17 +50,82 @@ public:
             }
         }
 
-        // Remove all unreachable states
-        for (int i = static_cast<int>(reachable.size()) - 1; i >= 0; i--) {
-            if (!reachable[i]) {
-                automaton.remove_state(i);
+        return reachable;
+    }
+
+    // Walks the reversed edges from the final states
+    std::vector<bool> find_co_reachable_states() const {
+        auto &states = automaton.get_states();
+
+        // Reversed edges in the compressed form: the sources of the edges into
+        // the state i are stored in sources[offsets[i]..offsets[i + 1])
+        std::vector<size_t> offsets(states.size() + 1, 0);
+        for (auto &state: states) {
+            for (auto &transition: state.transitions) {
+                offsets[transition.target_index + 1]++;
             }
         }
+        for (size_t i = 0; i < states.size(); i++) {
+            offsets[i + 1] += offsets[i];
+        }
+
+        std::vector<size_t> sources(offsets.back());
+        std::vector<size_t> positions(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < states.size(); i++) {
+            for (auto &transition: states[i].transitions) {
+                sources[positions[transition.target_index]++] = i;
+            }
+        }
+
+        std::vector<bool> co_reachable(states.size(), false);
+        std::vector<size_t> current_states;
+
+        for (size_t i = 0; i < states.size(); i++) {
+            if (states[i].is_final) {
+                co_reachable[i] = true;
+                current_states.push_back(i);
+            }
+        }
+
+        while (!current_states.empty()) {
+            size_t state_index = current_states.back();
+            current_states.pop_back();
+
+            for (size_t j = offsets[state_index]; j < offsets[state_index + 1]; j++) {
+                if (!co_reachable[sources[j]]) {
+                    co_reachable[sources[j]] = true;
+                    current_states.push_back(sources[j]);
+                }
+            }
+        }
+
+        return co_reachable;
+    }
+
+    void remove_unreachable_states() {
+        std::vector<bool> reachable = find_reachable_states();
+        reachable.flip();
+        automaton.remove_states(reachable);
+    }
+
+    // Keeps only the states which are both reachable and co-reachable. The
+    // start state always stays, so an empty language gives a single state.
+    void trim() {
+        std::vector<bool> reachable = find_reachable_states();
+        std::vector<bool> co_reachable = find_co_reachable_states();
+
+        std::vector<bool> removed(reachable.size());
+        for (size_t i = 0; i < removed.size(); i++) {
+            removed[i] = !reachable[i] || !co_reachable[i];
+        }
+        removed[automaton.get_start_state_index()] = false;
+
+        automaton.remove_states(removed);
     }
 
     void optimize() {
         remove_zero_transitions();
-        remove_unreachable_states();
+        trim();
     }
 
     FiniteAutomaton &automaton;
@@ -0,0 +1 @@
+#include "automaton-product.hpp"
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include "finite-automaton.hpp"
+#include "automaton-determinator.hpp"
+
+enum class AutomatonProductOperation {
+    Intersection, Union, Difference, SymmetricDifference
+};
+
+// A state of one of the operands inside a product state. In the deterministic
+// mode it's a superposition of operand states, otherwise a single state.
+// Empty set stands for the implicit dead state of the operand.
+using AutomatonProductComponent = std::vector<size_t>;
+
+struct AutomatonProductState {
+    AutomatonProductComponent left;
+    AutomatonProductComponent right;
+
+    bool operator==(const AutomatonProductState &other) const {
+        return left == other.left && right == other.right;
+    }
+};
+
+struct AutomatonProductStateHash {
+    size_t operator()(const AutomatonProductState &state) const {
+        size_t hash = state.left.size();
+        for (size_t index: state.left) {
+            hash = hash * 1000003 ^ index;
+        }
+        hash = hash * 1000003 ^ state.right.size();
+        for (size_t index: state.right) {
+            hash = hash * 1000003 ^ index;
+        }
+        return hash;
+    }
+};
+
+// Builds the product of two simple FA w/o epsilon-transitions. Only the pairs
+// reachable from the pair of start states are ever created. The result is
+// partial: pairs which can never become accepting are left out.
+//
+// With deterministic = false the operands are explored state by state, so
+// the product of two NFAs stays an NFA. The complemented operands (right one
+// for difference, both for symmetric difference) are still determinized on
+// the fly, since complement is not defined on NFA runs.
+
+class AutomatonProduct {
+public:
+    AutomatonProduct(const FiniteAutomaton &left, const FiniteAutomaton &right,
+                     AutomatonProductOperation operation, bool deterministic = true) :
+            left(left), right(right), operation(operation) {
+        assert(left.is_simple() && !left.has_epsilon_transitions());
+        assert(right.is_simple() && !right.has_epsilon_transitions());
+
+        left_is_superposition = deterministic || operation == AutomatonProductOperation::SymmetricDifference;
+        right_is_superposition = deterministic || operation == AutomatonProductOperation::Difference ||
+                                 operation == AutomatonProductOperation::SymmetricDifference;
+
+        alphabet = left.alphabet;
+        alphabet.insert(right.alphabet.begin(), right.alphabet.end());
+    }
+
+    FiniteAutomaton build() {
+        std::vector<SuperpositionTransition> transitions;
+
+        explore([&](size_t source, char c, size_t target) {
+            transitions.push_back({source, target, c});
+            return true;
+        });
+
+        FiniteAutomaton result;
+        result.extend_alphabet(alphabet);
+
+        for (auto &state: found_states) {
+            result.add_state(is_accepting(state));
+        }
+
+        for (auto &transition: transitions) {
+            result.add_transition(transition.source_index, transition.target_index, Regex(CharRegex(transition.ch)));
+        }
+
+        return result;
+    }
+
+    // Checks whether the resulting language is empty. Stops on the first
+    // accepting pair without building the rest of the product.
+    bool is_empty() {
+        bool found_accepting = false;
+
+        explore([&](size_t, char, size_t target) {
+            found_accepting = is_accepting(found_states[target]);
+            return !found_accepting;
+        });
+
+        return !found_accepting && !is_accepting(found_states[0]);
+    }
+
+    bool is_accepting(const AutomatonProductState &state) const {
+        bool left_final = is_final(left, state.left);
+        bool right_final = is_final(right, state.right);
+
+        switch (operation) {
+            case AutomatonProductOperation::Intersection:
+                return left_final && right_final;
+            case AutomatonProductOperation::Union:
+                return left_final || right_final;
+            case AutomatonProductOperation::Difference:
+                return left_final && !right_final;
+            case AutomatonProductOperation::SymmetricDifference:
+                return left_final != right_final;
+        }
+        return false;
+    }
+
+    const FiniteAutomaton &left;
+    const FiniteAutomaton &right;
+    AutomatonProductOperation operation;
+    std::set<char> alphabet;
+
+private:
+    static bool is_final(const FiniteAutomaton &automaton, const AutomatonProductComponent &component) {
+        for (size_t state: component) {
+            if (automaton.get_states()[state].is_final) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Whether the pair can never reach an accepting pair, judging by the dead components alone
+    bool is_hopeless(const AutomatonProductState &state) const {
+        switch (operation) {
+            case AutomatonProductOperation::Intersection:
+                return state.left.empty() || state.right.empty();
+            case AutomatonProductOperation::Difference:
+                return state.left.empty();
+            case AutomatonProductOperation::Union:
+            case AutomatonProductOperation::SymmetricDifference:
+                return state.left.empty() && state.right.empty();
+        }
+        return false;
+    }
+
+    static std::map<char, std::vector<size_t>>
+    get_component_transitions(const FiniteAutomaton &automaton, const AutomatonProductComponent &component) {
+        std::map<char, std::vector<size_t>> transitions;
+
+        for (size_t state: component) {
+            for (auto &transition: automaton.get_states()[state].transitions) {
+                transitions[CharRegex::get_char(transition.regex)].push_back(transition.target_index);
+            }
+        }
+
+        return transitions;
+    }
+
+    // Returns all the components the given component can move to with the letter
+    static std::vector<AutomatonProductComponent>
+    get_next_components(const std::map<char, std::vector<size_t>> &transitions, char c, bool is_superposition) {
+        auto it = transitions.find(c);
+        if (it == transitions.end()) {
+            return {{}};
+        }
+
+        std::vector<size_t> targets = it->second;
+        std::sort(targets.begin(), targets.end());
+        targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+
+        if (is_superposition) {
+            return {std::move(targets)};
+        }
+
+        std::vector<AutomatonProductComponent> result;
+        for (size_t target: targets) {
+            result.push_back({target});
+        }
+        return result;
+    }
+
+    size_t find_or_add_state(AutomatonProductState &&state, std::vector<size_t> &queue) {
+        auto it = state_indices.find(state);
+        if (it != state_indices.end()) {
+            return it->second;
+        }
+
+        size_t index = found_states.size();
+        state_indices.emplace(state, index);
+        found_states.push_back(std::move(state));
+        queue.push_back(index);
+        return index;
+    }
+
+    // Walks the reachable part of the product breadth-first, reporting every
+    // transition to the callback. Stops as soon as the callback returns false.
+    template<typename Callback>
+    void explore(Callback &&callback) {
+        found_states.clear();
+        state_indices.clear();
+
+        std::vector<size_t> queue;
+        find_or_add_state({{left.get_start_state_index()}, {right.get_start_state_index()}}, queue);
+
+        for (size_t position = 0; position < queue.size(); position++) {
+            size_t source = queue[position];
+
+            auto left_transitions = get_component_transitions(left, found_states[source].left);
+            auto right_transitions = get_component_transitions(right, found_states[source].right);
+
+            for (char c: alphabet) {
+                auto left_targets = get_next_components(left_transitions, c, left_is_superposition);
+                auto right_targets = get_next_components(right_transitions, c, right_is_superposition);
+
+                for (auto &left_target: left_targets) {
+                    for (auto &right_target: right_targets) {
+                        AutomatonProductState target_state{left_target, right_target};
+                        if (is_hopeless(target_state)) {
+                            continue;
+                        }
+
+                        size_t target = find_or_add_state(std::move(target_state), queue);
+                        if (!callback(source, c, target)) {
+                            return;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    bool left_is_superposition;
+    bool right_is_superposition;
+
+    std::vector<AutomatonProductState> found_states;
+    std::unordered_map<AutomatonProductState, size_t, AutomatonProductStateHash> state_indices;
+};
@@ -0,0 +1,44 @@
+#include "automaton-reverser.hpp"
+
+std::vector<size_t> AutomatonReverser::get_start_states() const {
+    std::vector<size_t> start_states;
+    auto &states = automaton.get_states();
+
+    for (size_t i = 0; i < states.size(); i++) {
+        if (states[i].is_final) {
+            start_states.push_back(i);
+        }
+    }
+
+    return start_states;
+}
+
+FiniteAutomaton AutomatonReverser::reverse() {
+    auto &states = automaton.get_states();
+
+    FiniteAutomaton result;
+    result.extend_alphabet(automaton.alphabet);
+
+    // Copies into the fresh start state may coincide, set semantics drops them
+    result.set_unique_transitions(true);
+
+    for (size_t i = 0; i < states.size(); i++) {
+        result.add_state(i == automaton.get_start_state_index());
+    }
+
+    size_t start = result.add_state(states[automaton.get_start_state_index()].is_final);
+    result.set_start_state(start);
+
+    for (size_t i = 0; i < states.size(); i++) {
+        for (auto &transition: states[i].transitions) {
+            result.add_transition(transition.target_index, i, transition.regex);
+
+            if (states[transition.target_index].is_final) {
+                result.add_transition(start, i, transition.regex);
+            }
+        }
+    }
+
+    result.set_unique_transitions(false);
+    return result;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "finite-automaton.hpp"
+
+// Builds the automaton of the reversed language. Every transition is turned
+// around, and the final states become the start states. An automaton has a
+// single start state, so the result gets a fresh one: it copies the outgoing
+// transitions of all the old final states and is final when the old start
+// state was. The fresh state doesn't need epsilon-transitions, so reversing
+// an automaton without them keeps it that way.
+//
+// The states of the input keep their indices in the result, the fresh start
+// state comes last. get_start_states() lists the states the fresh one stands
+// for, for the callers that run the reversed automaton from all of them at
+// once, like AutomatonDeterminator::set_start_states().
+
+class AutomatonReverser {
+public:
+    AutomatonReverser(const FiniteAutomaton &automaton) : automaton(automaton) {}
+
+    FiniteAutomaton reverse();
+
+    std::vector<size_t> get_start_states() const;
+
+    const FiniteAutomaton &automaton;
+};
@@ -82,11 +82,66 @@ bool AutomatonSimplifier::get_long_transition(size_t &state_index, size_t &trans
     return false;
 }
 
+// Every call to shorten_transition consumes exactly one of these nodes
+static size_t count_composite_nodes(const Regex &regex) {
+    switch (regex.type) {
+        case RegexType::Char:
+            return 0;
+        case RegexType::Concat: {
+            size_t count = 1;
+            for (auto &operand: std::get<ConcatRegex>(regex.value).operands) {
+                count += count_composite_nodes(operand);
+            }
+            return count;
+        }
+        case RegexType::Sum: {
+            size_t count = 1;
+            for (auto &operand: std::get<SumRegex>(regex.value).operands) {
+                count += count_composite_nodes(operand);
+            }
+            return count;
+        }
+        case RegexType::Star:
+            return 1 + count_composite_nodes(std::get<StarRegex>(regex.value).get_operand());
+    }
+    return 0;
+}
+
 void AutomatonSimplifier::simplify() {
+    // Transitions are shortened by index, so they mustn't move while it happens
+    UniqueTransitionsSuspension suspension(automaton);
+
     size_t state = -1;
     size_t transition_index = -1;
 
+    size_t done = 0;
+    size_t total = 0;
+
+    if (control) {
+        for (auto &automaton_state: automaton.get_states()) {
+            for (auto &transition: automaton_state.transitions) {
+                total += count_composite_nodes(transition.regex);
+            }
+        }
+    }
+
     while (get_long_transition(state, transition_index)) {
+        if (control && control->should_stop()) {
+            return;
+        }
+
         shorten_transition(state, transition_index);
+
+        if (control) {
+            done++;
+            control->report_progress("simplify", done, total > done ? total - done : 1);
+        }
+    }
+
+    // Sums with equal operands leave duplicate transitions behind
+    automaton.canonicalize();
+
+    if (control) {
+        control->report_progress("simplify", done, 0);
     }
 }
\ No newline at end of file
@@ -1,13 +1,15 @@
 #pragma once
 
 #include "finite-automaton.hpp"
+#include "pipeline-control.hpp"
 
 // Removes all complex transitions from the automaton
 // Only leaves transitions with a single character or an epsilon
 
 class AutomatonSimplifier {
 public:
-    AutomatonSimplifier(FiniteAutomaton &automaton) : automaton(automaton) {
+    AutomatonSimplifier(FiniteAutomaton &automaton, PipelineControl *control = nullptr) :
+            automaton(automaton), control(control) {
 
     }
 
@@ -18,4 +20,5 @@ public:
     void simplify();
 
     FiniteAutomaton &automaton;
+    PipelineControl *control;
 };
\ No newline at end of file
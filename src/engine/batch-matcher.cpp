@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <bit>
+#include "batch-matcher.hpp"
+#include "interleaved-dfa-matcher.hpp"
+
+size_t MatchBitmap::count() const {
+    size_t result = 0;
+    for (uint64_t word: words) {
+        result += std::popcount(word);
+    }
+    return result;
+}
+
+BatchMatcher::BatchMatcher(const CompiledDfa &dfa, ThreadPool &pool) : dfa(&dfa), pool(pool) {}
+
+BatchMatcher::BatchMatcher(const FiniteAutomaton &automaton, ThreadPool &pool) : pool(pool) {
+    assert(automaton.is_simple());
+
+    auto &states = automaton.get_states();
+    start_state = static_cast<uint32_t>(automaton.get_start_state_index());
+    transition_begins.push_back(0);
+    epsilon_begins.push_back(0);
+
+    std::vector<std::pair<unsigned char, uint32_t>> row;
+
+    for (auto &state: states) {
+        row.clear();
+        for (auto &transition: state.transitions) {
+            char letter = CharRegex::get_char(transition.regex);
+            if (letter == '\0') {
+                epsilon_targets.push_back(static_cast<uint32_t>(transition.target_index));
+            } else {
+                row.emplace_back(static_cast<unsigned char>(letter), static_cast<uint32_t>(transition.target_index));
+            }
+        }
+
+        std::sort(row.begin(), row.end());
+        for (auto &[letter, target]: row) {
+            transition_letters.push_back(letter);
+            transition_targets.push_back(target);
+        }
+
+        transition_begins.push_back(static_cast<uint32_t>(transition_letters.size()));
+        epsilon_begins.push_back(static_cast<uint32_t>(epsilon_targets.size()));
+        finals.push_back(state.is_final);
+    }
+}
+
+void BatchMatcher::add_closure(uint32_t state, Scratch &scratch) const {
+    if (scratch.marks[state] == scratch.step) {
+        return;
+    }
+
+    // The next list doubles as the stack of the search, its tail is what's left to expand
+    size_t expanded = scratch.next.size();
+    scratch.marks[state] = scratch.step;
+    scratch.next.push_back(state);
+
+    while (expanded < scratch.next.size()) {
+        uint32_t source = scratch.next[expanded++];
+        for (uint32_t i = epsilon_begins[source]; i < epsilon_begins[source + 1]; i++) {
+            uint32_t target = epsilon_targets[i];
+            if (scratch.marks[target] != scratch.step) {
+                scratch.marks[target] = scratch.step;
+                scratch.next.push_back(target);
+            }
+        }
+    }
+}
+
+bool BatchMatcher::simulate(std::string_view input, Scratch &scratch) const {
+    if (finals.empty()) {
+        return false;
+    }
+
+    auto next_step = [&] {
+        scratch.next.clear();
+        // Stamps wrap around once in 2^32 steps, then the old ones must go
+        if (++scratch.step == 0) {
+            std::fill(scratch.marks.begin(), scratch.marks.end(), 0);
+            scratch.step = 1;
+        }
+    };
+
+    next_step();
+    add_closure(start_state, scratch);
+    std::swap(scratch.current, scratch.next);
+
+    for (char c: input) {
+        auto letter = static_cast<unsigned char>(c);
+        next_step();
+
+        for (uint32_t state: scratch.current) {
+            auto begin = transition_letters.begin() + transition_begins[state];
+            auto end = transition_letters.begin() + transition_begins[state + 1];
+            for (auto it = std::lower_bound(begin, end, letter); it != end && *it == letter; ++it) {
+                add_closure(transition_targets[it - transition_letters.begin()], scratch);
+            }
+        }
+
+        std::swap(scratch.current, scratch.next);
+        if (scratch.current.empty()) {
+            return false;
+        }
+    }
+
+    return std::any_of(scratch.current.begin(), scratch.current.end(), [&](uint32_t state) {
+        return finals[state] != 0;
+    });
+}
+
+template<typename Input>
+MatchBitmap BatchMatcher::accepts_all(size_t count, const Input &input) const {
+    MatchBitmap result(count);
+    std::vector<Scratch> scratches(pool.get_thread_count());
+    size_t block_count = (count + block_size - 1) / block_size;
+
+    pool.parallel_for(block_count, [&](size_t block, size_t thread_index) {
+        Scratch &scratch = scratches[thread_index];
+        size_t begin = block * block_size;
+        size_t end = std::min(begin + block_size, count);
+
+        if (dfa) {
+            scratch.views.clear();
+            for (size_t i = begin; i < end; i++) {
+                scratch.views.push_back(input(i));
+            }
+            scratch.results.resize(scratch.views.size());
+            InterleavedDfaMatcher(*dfa).accepts(scratch.views, scratch.results.data());
+
+            for (size_t i = begin; i < end; i++) {
+                if (scratch.results[i - begin]) {
+                    result.set(i);
+                }
+            }
+            return;
+        }
+
+        if (scratch.marks.empty()) {
+            scratch.marks.assign(finals.size(), 0);
+        }
+        for (size_t i = begin; i < end; i++) {
+            if (simulate(input(i), scratch)) {
+                result.set(i);
+            }
+        }
+    });
+
+    return result;
+}
+
+MatchBitmap BatchMatcher::accepts(std::span<const std::string_view> inputs) const {
+    return accepts_all(inputs.size(), [&](size_t i) { return inputs[i]; });
+}
+
+MatchBitmap BatchMatcher::accepts(std::string_view blob, std::span<const size_t> offsets) const {
+    if (offsets.empty()) {
+        return MatchBitmap();
+    }
+    assert(std::is_sorted(offsets.begin(), offsets.end()) && offsets.back() <= blob.size());
+
+    return accepts_all(offsets.size() - 1, [&](size_t i) {
+        return blob.substr(offsets[i], offsets[i + 1] - offsets[i]);
+    });
+}
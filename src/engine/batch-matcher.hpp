@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "compiled-dfa.hpp"
+#include "finite-automaton.hpp"
+#include "thread-pool.hpp"
+
+// One bit per input of a batch, set when the input is accepted
+class MatchBitmap {
+public:
+    explicit MatchBitmap(size_t size = 0) : words((size + 63) / 64, 0), bit_count(size) {}
+
+    bool operator[](size_t index) const { return (words[index / 64] >> (index % 64)) & 1; }
+
+    void set(size_t index) { words[index / 64] |= uint64_t(1) << (index % 64); }
+
+    size_t size() const { return bit_count; }
+
+    // Number of accepted inputs
+    size_t count() const;
+
+    const std::vector<uint64_t> &get_words() const { return words; }
+
+private:
+    std::vector<uint64_t> words;
+    size_t bit_count;
+};
+
+// Matches millions of inputs against one automaton on a thread pool. The
+// inputs are handed out in blocks of whole bitmap words, so the threads never
+// write the same word, and everything a thread needs while matching is
+// allocated once per thread and batch instead of once per input.
+//
+// A CompiledDfa is run by the interleaved matcher within a block. A
+// FiniteAutomaton, which may have epsilon transitions, is simulated on flat
+// adjacency arrays, with the current states kept in a list and marked in a
+// per-thread array stamped with the step number, so a step doesn't clear or
+// allocate anything.
+//
+// The inputs are either string views or a blob with offsets, where input i is
+// blob[offsets[i], offsets[i + 1]).
+
+class BatchMatcher {
+public:
+    // Inputs per block, a multiple of the 64 bits of a bitmap word
+    static constexpr size_t block_size = 4096;
+
+    BatchMatcher(const CompiledDfa &dfa, ThreadPool &pool);
+
+    BatchMatcher(const FiniteAutomaton &automaton, ThreadPool &pool);
+
+    MatchBitmap accepts(std::span<const std::string_view> inputs) const;
+
+    // The offsets must not decrease and the last one must be within the
+    // blob. There's one input less than there are offsets, none without any.
+    MatchBitmap accepts(std::string_view blob, std::span<const size_t> offsets) const;
+
+private:
+    struct Scratch {
+        std::vector<std::string_view> views;
+        std::vector<uint8_t> results;
+
+        // Current and next states of the simulation, and the step each state was last added in
+        std::vector<uint32_t> current;
+        std::vector<uint32_t> next;
+        std::vector<uint32_t> marks;
+        uint32_t step = 0;
+    };
+
+    template<typename Input>
+    MatchBitmap accepts_all(size_t count, const Input &input) const;
+
+    bool simulate(std::string_view input, Scratch &scratch) const;
+
+    // Adds the state and everything reachable from it by epsilon transitions
+    void add_closure(uint32_t state, Scratch &scratch) const;
+
+    const CompiledDfa *dfa = nullptr;
+    ThreadPool &pool;
+
+    // The automaton in compressed rows: the letter transitions of state s are
+    // [transition_begins[s], transition_begins[s + 1]), sorted by letter
+    std::vector<uint32_t> transition_begins;
+    std::vector<unsigned char> transition_letters;
+    std::vector<uint32_t> transition_targets;
+    std::vector<uint32_t> epsilon_begins;
+    std::vector<uint32_t> epsilon_targets;
+    std::vector<uint8_t> finals;
+    uint32_t start_state = 0;
+};
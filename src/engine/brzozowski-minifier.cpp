@@ -0,0 +1,28 @@
+#include "brzozowski-minifier.hpp"
+#include "automaton-reverser.hpp"
+#include "automaton-determinator.hpp"
+
+// The fresh start state of the reversal would become a DFA state of its own,
+// equivalent to the set of the old final states. Starting the subset
+// construction from that set keeps the result minimal.
+FiniteAutomaton BrzozowskiMinifier::determine_reversal(const FiniteAutomaton &input) {
+    AutomatonReverser reverser(input);
+    FiniteAutomaton reversed = reverser.reverse();
+    std::vector<size_t> start_states = reverser.get_start_states();
+
+    if (start_states.empty()) {
+        // The language is empty, as is its reversal
+        return FiniteAutomaton::empty_language(input.alphabet);
+    }
+
+    AutomatonDeterminator determinator(reversed);
+    determinator.set_start_states(start_states);
+    return determinator.determine();
+}
+
+FiniteAutomaton BrzozowskiMinifier::minify() {
+    assert(!automaton.has_epsilon_transitions());
+
+    FiniteAutomaton reversed_dfa = determine_reversal(automaton);
+    return determine_reversal(reversed_dfa);
+}
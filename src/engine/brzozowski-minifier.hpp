@@ -0,0 +1,25 @@
+#pragma once
+
+#include "finite-automaton.hpp"
+
+// Minimizes an automaton by double reversal: determinizing the reversal of a
+// DFA with only reachable states gives the minimal DFA of the reversed
+// language, so reverse, determinize, reverse and determinize again.
+//
+// Unlike AutomatonMinifier, the input may be any automaton without
+// epsilon-transitions, and no full DFA of it is ever built. That wins when
+// the DFA of the input is large but the one of its reversal is small, and
+// loses when it's the other way around. The result is trim, so it has no
+// dead state even if the input is complete.
+
+class BrzozowskiMinifier {
+public:
+    BrzozowskiMinifier(const FiniteAutomaton &automaton) : automaton(automaton) {}
+
+    FiniteAutomaton minify();
+
+    const FiniteAutomaton &automaton;
+
+private:
+    static FiniteAutomaton determine_reversal(const FiniteAutomaton &input);
+};
@@ -0,0 +1,88 @@
+#include <map>
+#include "compiled-dfa.hpp"
+#include "automaton-determinator.hpp"
+#include "automaton-optimizer.hpp"
+#include "automaton-minifier.hpp"
+
+CompiledDfa::CompiledDfa(const FiniteAutomaton &automaton) {
+    assert(automaton.is_deterministic());
+
+    auto &states = automaton.get_states();
+    size_t state_count = states.size() + 1;
+
+    std::set<char> letters = automaton.alphabet;
+    for (auto &state: states) {
+        for (auto &transition: state.transitions) {
+            letters.insert(CharRegex::get_char(transition.regex));
+        }
+    }
+
+    // Column of the table for every letter, FA state i becomes state i + 1
+    std::map<char, std::vector<uint32_t>> columns;
+    for (char letter: letters) {
+        columns[letter].assign(state_count, dead_state);
+    }
+
+    for (size_t i = 0; i < states.size(); i++) {
+        for (auto &transition: states[i].transitions) {
+            columns[CharRegex::get_char(transition.regex)][i + 1] = static_cast<uint32_t>(transition.target_index + 1);
+        }
+    }
+
+    // Letters with equal columns share a byte class, class 0 is all-dead
+    std::map<std::vector<uint32_t>, uint8_t> column_classes;
+    column_classes[std::vector<uint32_t>(state_count, dead_state)] = 0;
+    std::vector<const std::vector<uint32_t> *> class_columns = {nullptr};
+
+    for (auto &[letter, column]: columns) {
+        auto it = column_classes.find(column);
+        if (it == column_classes.end()) {
+            it = column_classes.emplace(column, static_cast<uint8_t>(class_columns.size())).first;
+            class_columns.push_back(&it->first);
+        }
+        byte_classes[static_cast<unsigned char>(letter)] = it->second;
+    }
+
+    class_count = class_columns.size();
+    transitions.assign(state_count * class_count, dead_state);
+
+    for (size_t cls = 1; cls < class_count; cls++) {
+        auto &column = *class_columns[cls];
+        for (size_t state = 0; state < state_count; state++) {
+            transitions[state * class_count + cls] = column[state];
+        }
+    }
+
+    finals.assign(state_count, 0);
+    for (size_t i = 0; i < states.size(); i++) {
+        finals[i + 1] = states[i].is_final ? 1 : 0;
+    }
+
+    start_state = states.empty() ? dead_state : static_cast<uint32_t>(automaton.get_start_state_index() + 1);
+}
+
+std::optional<CompiledDfa> CompiledDfa::try_minimal(const FiniteAutomaton &automaton,
+                                                    const DeterminizationLimits &limits,
+                                                    PipelineControl *control) {
+    std::optional<FiniteAutomaton> dfa = AutomatonDeterminator(automaton, limits, control).try_determine();
+    if (!dfa) {
+        return std::nullopt;
+    }
+
+    AutomatonOptimizer(*dfa).trim();
+    FiniteAutomaton minimal = AutomatonMinifier(*dfa, control).minify();
+    if (control && control->is_stopped()) {
+        return std::nullopt;
+    }
+    return CompiledDfa(minimal);
+}
+
+uint32_t CompiledDfa::run(uint32_t state, std::string_view input) const {
+    for (char c: input) {
+        state = step(state, static_cast<unsigned char>(c));
+        if (state == dead_state) {
+            break;
+        }
+    }
+    return state;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include "finite-automaton.hpp"
+
+struct DeterminizationLimits;
+class PipelineControl;
+
+// Dense transition table of a DFA over bytes, for matching. Bytes which no
+// state can tell apart share a column of the table (a byte class), bytes
+// outside of the alphabet go to class 0. State 0 is the dead state: every
+// missing transition of the source automaton leads there, and it never
+// leaves it, so matching can stop as soon as it's reached.
+
+class CompiledDfa {
+public:
+    static constexpr uint32_t dead_state = 0;
+
+    CompiledDfa() = default;
+
+    explicit CompiledDfa(const FiniteAutomaton &automaton);
+
+    // Determinizes, trims and minimizes an automaton without epsilon transitions
+    // first. Returns nothing when the DFA outgrows the limits or the pipeline is stopped.
+    static std::optional<CompiledDfa> try_minimal(const FiniteAutomaton &automaton,
+                                                  const DeterminizationLimits &limits,
+                                                  PipelineControl *control = nullptr);
+
+    uint32_t step(uint32_t state, unsigned char byte) const {
+        return transitions[state * class_count + byte_classes[byte]];
+    }
+
+    // Runs the input from the given state, stops early in the dead state
+    uint32_t run(uint32_t state, std::string_view input) const;
+
+    bool accepts(std::string_view input) const {
+        return is_final(run(start_state, input));
+    }
+
+    bool is_final(uint32_t state) const { return finals[state] != 0; }
+
+    uint32_t get_start_state() const { return start_state; }
+
+    size_t get_state_count() const { return finals.size(); }
+
+    size_t get_class_count() const { return class_count; }
+
+    uint8_t get_byte_class(unsigned char byte) const { return byte_classes[byte]; }
+
+    const std::vector<uint32_t> &get_transitions() const { return transitions; }
+
+private:
+    std::vector<uint32_t> transitions;
+    std::vector<uint8_t> finals;
+    std::array<uint8_t, 256> byte_classes{};
+    size_t class_count = 1;
+    uint32_t start_state = dead_state;
+};
@@ -0,0 +1 @@
+#include "derivative-automaton-builder.hpp"
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <unordered_map>
+#include "finite-automaton.hpp"
+#include "regex-derivative.hpp"
+
+// Builds a complete DFA straight from a regex with Brzozowski derivatives.
+// Every state is a normalized derivative of the regex, the state is final
+// when its derivative is nullable. The ∅ derivative becomes the trap state.
+// Skips the simplification, epsilon removal and completion stages, and the
+// result is often close to the minimal DFA.
+
+class DerivativeAutomatonBuilder {
+public:
+    DerivativeAutomatonBuilder(const Regex &regex, const std::set<char> &alphabet = {}) :
+            regex(regex), alphabet(alphabet) {
+        regex.fill_alphabet(this->alphabet);
+    }
+
+    FiniteAutomaton build() {
+        FiniteAutomaton result;
+        result.extend_alphabet(alphabet);
+
+        std::vector<Regex> states;
+        std::unordered_map<Regex, size_t, RegexHash> state_indices;
+
+        auto find_or_add_state = [&](Regex &&derivative) {
+            auto it = state_indices.find(derivative);
+            if (it != state_indices.end()) {
+                return it->second;
+            }
+
+            size_t index = result.add_state(RegexDerivative::is_nullable(derivative));
+            state_indices.emplace(derivative, index);
+            states.push_back(std::move(derivative));
+            return index;
+        };
+
+        find_or_add_state(RegexDerivative::normalize(regex));
+
+        for (size_t state = 0; state < states.size(); state++) {
+            for (char c: alphabet) {
+                size_t target = find_or_add_state(RegexDerivative::derive(states[state], c));
+                result.add_transition(state, target, Regex(CharRegex(c)));
+            }
+        }
+
+        return result;
+    }
+
+    const Regex &regex;
+    std::set<char> alphabet;
+};
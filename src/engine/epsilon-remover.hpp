@@ -2,11 +2,14 @@
 
 // Removes unnecessary epsilon transitions from the automaton
 
+#include <algorithm>
 #include "finite-automaton.hpp"
+#include "pipeline-control.hpp"
 
 class EpsilonRemover {
 public:
-    EpsilonRemover(FiniteAutomaton &automaton) : automaton(automaton) {
+    EpsilonRemover(FiniteAutomaton &automaton, PipelineControl *control = nullptr) :
+            automaton(automaton), control(control) {
 
     }
 
@@ -131,13 +134,44 @@ public:
         return true;
     }
 
+    size_t count_epsilon_transitions() const {
+        size_t count = 0;
+        for (auto &state: automaton.get_states()) {
+            for (auto &transition: state.transitions) {
+                if (transition.regex.is_empty()) {
+                    count++;
+                }
+            }
+        }
+        return count;
+    }
+
     void simplify() {
+        // Removing a transition may copy other epsilon-transitions,
+        // so the initial count is only an estimate of the work left
+        size_t done = 0;
+        size_t total = control ? count_epsilon_transitions() : 0;
+
+        // Transitions are copied while iterating over them by index
+        UniqueTransitionsSuspension suspension(automaton);
+
         auto &states = automaton.get_states();
         for (size_t i = 0; i < states.size(); i++) {
+            // Copied transitions pile up duplicates, which would be removed over and over
+            automaton.canonicalize_state(i);
+
             auto &transitions = states[i].transitions;
             for (size_t j = 0; j < transitions.size(); j++) {
                 auto &regex = transitions[j].regex;
                 if (regex.type == RegexType::Char && std::get<CharRegex>(regex.value).ch == '\0') {
+                    if (control) {
+                        if (control->should_stop()) {
+                            return;
+                        }
+                        done++;
+                        control->report_progress("remove epsilon", done, total > done ? total - done : 1);
+                    }
+
                     if (remove_epsilon_loop(i)) {
                         i = -1;
                         break;
@@ -148,7 +182,14 @@ public:
                 }
             }
         }
+
+        automaton.canonicalize();
+
+        if (control) {
+            control->report_progress("remove epsilon", done, 0);
+        }
     }
 
     FiniteAutomaton &automaton;
+    PipelineControl *control;
 };
\ No newline at end of file
@@ -17,13 +17,17 @@ FiniteAutomaton::FiniteAutomaton(FiniteAutomaton &&move) noexcept {
 
 FiniteAutomaton &FiniteAutomaton::operator=(FiniteAutomaton &&move) {
     states = std::move(move.states);
+    alphabet = std::move(move.alphabet);
     start_state_index = move.start_state_index;
+    unique_transitions = move.unique_transitions;
     return *this;
 }
 
 FiniteAutomaton &FiniteAutomaton::operator=(const FiniteAutomaton &copy) {
     states = copy.states;
+    alphabet = copy.alphabet;
     start_state_index = copy.start_state_index;
+    unique_transitions = copy.unique_transitions;
     return *this;
 }
 
@@ -137,12 +141,61 @@ void FiniteAutomaton::remove_state(size_t state_index) {
     states.erase(states.begin() + state_index);
 }
 
+void FiniteAutomaton::remove_states(const std::vector<bool> &removed) {
+    assert(removed.size() == states.size());
+    assert(!removed[start_state_index]);
+
+    std::vector<size_t> new_indices(states.size(), -1);
+    size_t new_count = 0;
+
+    for (size_t i = 0; i < states.size(); i++) {
+        if (!removed[i]) {
+            new_indices[i] = new_count++;
+        }
+    }
+
+    for (size_t i = 0; i < states.size(); i++) {
+        if (removed[i]) {
+            continue;
+        }
+
+        auto &transitions = states[i].transitions;
+        size_t kept = 0;
+
+        for (size_t j = 0; j < transitions.size(); j++) {
+            size_t target_index = new_indices[transitions[j].target_index];
+            if (target_index != -1) {
+                transitions[j].target_index = target_index;
+                if (kept != j) {
+                    transitions[kept] = std::move(transitions[j]);
+                }
+                kept++;
+            }
+        }
+
+        transitions.erase(transitions.begin() + kept, transitions.end());
+        if (new_indices[i] != i) {
+            states[new_indices[i]] = std::move(states[i]);
+        }
+    }
+
+    states.resize(new_count);
+    start_state_index = new_indices[start_state_index];
+}
+
 void FiniteAutomaton::extend_alphabet(const std::set<char> &other_alphabet) {
     for (char ch: other_alphabet) {
         alphabet.insert(ch);
     }
 }
 
+FiniteAutomaton FiniteAutomaton::empty_language(const std::set<char> &alphabet) {
+    FiniteAutomaton automaton;
+    automaton.add_state(false);
+    automaton.extend_alphabet(alphabet);
+    return automaton;
+}
+
 bool FiniteAutomaton::is_simple() const {
     for (auto &state: states) {
         for(int i = 0; i < state.transitions.size(); i++) {
@@ -246,3 +299,22 @@ int FiniteAutomaton::find_transition(char c, size_t source_index, size_t target_
 void FiniteAutomaton::set_start_state(size_t state) {
     start_state_index = state;
 }
+
+void FiniteAutomaton::canonicalize() {
+    for (size_t i = 0; i < states.size(); i++) {
+        canonicalize_state(i);
+    }
+}
+
+void FiniteAutomaton::canonicalize_state(size_t state_index) {
+    auto &transitions = states[state_index].transitions;
+    std::sort(transitions.begin(), transitions.end());
+    transitions.erase(std::unique(transitions.begin(), transitions.end()), transitions.end());
+}
+
+void FiniteAutomaton::set_unique_transitions(bool enabled) {
+    if (enabled && !unique_transitions) {
+        canonicalize();
+    }
+    unique_transitions = enabled;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <set>
 #include <string>
 #include <map>
@@ -9,6 +10,18 @@
 struct FiniteAutomatonTransition {
     Regex regex;
     size_t target_index;
+
+    bool operator==(const FiniteAutomatonTransition &other) const {
+        return target_index == other.target_index && regex == other.regex;
+    }
+
+    // Canonical order of the adjacency: by regex, then by target
+    bool operator<(const FiniteAutomatonTransition &other) const {
+        if (regex == other.regex) {
+            return target_index < other.target_index;
+        }
+        return regex < other.regex;
+    }
 };
 
 struct FiniteAutomatonState {
@@ -41,7 +54,18 @@ public:
     template<typename T>
     void add_transition(size_t from, size_t to, T &&regex) {
         regex.fill_alphabet(alphabet);
-        states[from].transitions.push_back(FiniteAutomatonTransition{std::forward<T>(regex), to});
+
+        auto &transitions = states[from].transitions;
+        if (!unique_transitions) {
+            transitions.push_back(FiniteAutomatonTransition{std::forward<T>(regex), to});
+            return;
+        }
+
+        FiniteAutomatonTransition transition{std::forward<T>(regex), to};
+        auto it = std::lower_bound(transitions.begin(), transitions.end(), transition);
+        if (it == transitions.end() || !(*it == transition)) {
+            transitions.insert(it, std::move(transition));
+        }
     }
 
     const std::vector<FiniteAutomatonState> &get_states() const { return states; }
@@ -56,10 +80,16 @@ public:
 
     void remove_state(size_t i);
 
+    // Removes all the marked states at once, in linear time. The start state must stay.
+    void remove_states(const std::vector<bool> &removed);
+
     std::set<char> alphabet;
 
     void extend_alphabet(const std::set<char> &alphabet);
 
+    // A single non-final state without transitions
+    static FiniteAutomaton empty_language(const std::set<char> &alphabet = {});
+
     bool is_simple() const;
     bool is_complete() const;
     bool is_deterministic() const;
@@ -71,7 +101,42 @@ public:
 
     void set_start_state(size_t state);
 
+    // Sorts the transitions of every state and drops the duplicate ones
+    void canonicalize();
+
+    void canonicalize_state(size_t state_index);
+
+    // With set semantics on, the adjacency of every state is kept sorted and
+    // add_transition ignores a transition which is already there. Stages that
+    // add transitions while iterating over them by index must keep it off.
+    void set_unique_transitions(bool enabled);
+
+    bool has_unique_transitions() const { return unique_transitions; }
+
 private:
     std::vector<FiniteAutomatonState> states;
     size_t start_state_index = 0;
+    bool unique_transitions = false;
+};
+
+// Turns the set semantics of an automaton off for a scope, and back to what
+// they were when the scope is left, however it's left
+class UniqueTransitionsSuspension {
+public:
+    explicit UniqueTransitionsSuspension(FiniteAutomaton &automaton) :
+            automaton(automaton), unique_transitions(automaton.has_unique_transitions()) {
+        automaton.set_unique_transitions(false);
+    }
+
+    ~UniqueTransitionsSuspension() {
+        automaton.set_unique_transitions(unique_transitions);
+    }
+
+    UniqueTransitionsSuspension(const UniqueTransitionsSuspension &copy) = delete;
+
+    UniqueTransitionsSuspension &operator=(const UniqueTransitionsSuspension &copy) = delete;
+
+private:
+    FiniteAutomaton &automaton;
+    bool unique_transitions;
 };
\ No newline at end of file
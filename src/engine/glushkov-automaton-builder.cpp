@@ -0,0 +1,96 @@
+#include <algorithm>
+#include "glushkov-automaton-builder.hpp"
+
+FiniteAutomaton GlushkovAutomatonBuilder::build() {
+    letters = {'\0'};
+    follow = {{}};
+
+    GlushkovSubexpression root = visit(regex);
+
+    FiniteAutomaton result;
+    result.extend_alphabet(alphabet);
+
+    result.add_state(root.is_nullable);
+    for (size_t position = 1; position < letters.size(); position++) {
+        result.add_state(false);
+    }
+
+    for (size_t position: root.last) {
+        result.make_state_final(position, true);
+    }
+
+    follow[0] = root.first;
+
+    for (size_t position = 0; position < letters.size(); position++) {
+        auto &targets = follow[position];
+        std::sort(targets.begin(), targets.end());
+        targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+
+        for (size_t target: targets) {
+            result.add_transition(position, target, Regex(CharRegex(letters[target])));
+        }
+    }
+
+    return result;
+}
+
+GlushkovSubexpression GlushkovAutomatonBuilder::visit(const Regex &subexpression) {
+    switch (subexpression.type) {
+        case RegexType::Char: {
+            char c = std::get<CharRegex>(subexpression.value).ch;
+            if (c == '\0') {
+                return {true, {}, {}};
+            }
+
+            size_t position = letters.size();
+            letters.push_back(c);
+            follow.emplace_back();
+            return {false, {position}, {position}};
+        }
+        case RegexType::Concat: {
+            GlushkovSubexpression result{true, {}, {}};
+
+            for (auto &operand: std::get<ConcatRegex>(subexpression.value).operands) {
+                GlushkovSubexpression next = visit(operand);
+                add_follow(result.last, next.first);
+
+                if (result.is_nullable) {
+                    result.first.insert(result.first.end(), next.first.begin(), next.first.end());
+                }
+                if (next.is_nullable) {
+                    next.last.insert(next.last.end(), result.last.begin(), result.last.end());
+                }
+
+                result.last = std::move(next.last);
+                result.is_nullable = result.is_nullable && next.is_nullable;
+            }
+
+            return result;
+        }
+        case RegexType::Sum: {
+            GlushkovSubexpression result{false, {}, {}};
+
+            for (auto &operand: std::get<SumRegex>(subexpression.value).operands) {
+                GlushkovSubexpression next = visit(operand);
+                result.is_nullable = result.is_nullable || next.is_nullable;
+                result.first.insert(result.first.end(), next.first.begin(), next.first.end());
+                result.last.insert(result.last.end(), next.last.begin(), next.last.end());
+            }
+
+            return result;
+        }
+        case RegexType::Star: {
+            GlushkovSubexpression result = visit(std::get<StarRegex>(subexpression.value).get_operand());
+            add_follow(result.last, result.first);
+            result.is_nullable = true;
+            return result;
+        }
+    }
+    return {};
+}
+
+void GlushkovAutomatonBuilder::add_follow(const std::vector<size_t> &from, const std::vector<size_t> &to) {
+    for (size_t position: from) {
+        follow[position].insert(follow[position].end(), to.begin(), to.end());
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "finite-automaton.hpp"
+
+struct GlushkovSubexpression {
+    bool is_nullable = false;
+    std::vector<size_t> first;
+    std::vector<size_t> last;
+};
+
+// Builds the position (Glushkov) automaton of a regex. Every occurrence of a
+// letter in the regex becomes a state, and there's one more initial state.
+// The first, last and follow sets are collected in a single pass over the
+// regex tree. The result is simple and has no epsilon-transitions, so it can
+// go to AutomatonDeterminator without the simplifier and epsilon remover.
+
+class GlushkovAutomatonBuilder {
+public:
+    GlushkovAutomatonBuilder(const Regex &regex, const std::set<char> &alphabet = {}) :
+            regex(regex), alphabet(alphabet) {}
+
+    FiniteAutomaton build();
+
+    const Regex &regex;
+    std::set<char> alphabet;
+
+private:
+    GlushkovSubexpression visit(const Regex &subexpression);
+
+    void add_follow(const std::vector<size_t> &from, const std::vector<size_t> &to);
+
+    // Letters of the positions, position 0 is the initial state
+    std::vector<char> letters;
+    std::vector<std::vector<size_t>> follow;
+};
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include "interleaved-dfa-matcher.hpp"
+
+namespace {
+
+struct InterleavedLane {
+    const unsigned char *position;
+    const unsigned char *end;
+    uint32_t state;
+    size_t input;
+};
+
+}
+
+InterleavedDfaMatcher::InterleavedDfaMatcher(const CompiledDfa &dfa, size_t lanes) :
+        dfa(dfa), lanes(std::clamp<size_t>(lanes, 1, max_lanes)) {}
+
+void InterleavedDfaMatcher::accepts(std::span<const std::string_view> inputs, uint8_t *results) const {
+    const uint32_t *transitions = dfa.get_transitions().data();
+    size_t class_count = dfa.get_class_count();
+
+    uint8_t byte_classes[256];
+    for (size_t byte = 0; byte < 256; byte++) {
+        byte_classes[byte] = dfa.get_byte_class(static_cast<unsigned char>(byte));
+    }
+
+    InterleavedLane active[max_lanes];
+    size_t active_count = 0;
+    size_t next_input = 0;
+
+    auto load = [&](InterleavedLane &lane) {
+        auto &input = inputs[next_input];
+        auto begin = reinterpret_cast<const unsigned char *>(input.data());
+        lane = {begin, begin + input.size(), dfa.get_start_state(), next_input};
+        next_input++;
+
+        // The lanes will get to the inputs after this one soon
+        if (next_input + lanes < inputs.size()) {
+            __builtin_prefetch(inputs[next_input + lanes].data());
+        }
+    };
+
+    while (active_count < lanes && next_input < inputs.size()) {
+        load(active[active_count++]);
+    }
+
+    while (active_count > 0) {
+        size_t rounds = max_rounds;
+        for (size_t i = 0; i < active_count; i++) {
+            rounds = std::min<size_t>(rounds, active[i].end - active[i].position);
+        }
+
+        for (size_t round = 0; round < rounds; round++) {
+            for (size_t i = 0; i < active_count; i++) {
+                auto &lane = active[i];
+                lane.state = transitions[lane.state * class_count + byte_classes[*lane.position++]];
+                __builtin_prefetch(transitions + lane.state * class_count);
+            }
+        }
+
+        // A finished lane takes the next input, or the last lane's place when there are none
+        for (size_t i = 0; i < active_count;) {
+            auto &lane = active[i];
+            if (lane.position != lane.end && lane.state != CompiledDfa::dead_state) {
+                i++;
+                continue;
+            }
+
+            results[lane.input] = dfa.is_final(lane.state) ? 1 : 0;
+
+            if (next_input < inputs.size()) {
+                load(lane);
+            } else {
+                lane = active[--active_count];
+            }
+        }
+    }
+}
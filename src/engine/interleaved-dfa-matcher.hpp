@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "compiled-dfa.hpp"
+
+// Matches many independent inputs against a CompiledDfa at once. Matching a
+// single input is a chain of dependent table loads, so when the table doesn't
+// fit in the cache most of the time goes to waiting for memory. Here several
+// inputs (lanes) advance in lockstep, one byte each per round, so the loads of
+// different lanes overlap, and the row of the next state of every lane is
+// prefetched as soon as it's known.
+//
+// Lanes run for as many rounds as the shortest of them allows without any
+// checks, then the finished ones take the next inputs, so inputs of uneven
+// length keep all the lanes busy.
+
+class InterleavedDfaMatcher {
+public:
+    static constexpr size_t max_lanes = 16;
+
+    // Rounds between the checks for the dead state
+    static constexpr size_t max_rounds = 64;
+
+    explicit InterleavedDfaMatcher(const CompiledDfa &dfa, size_t lanes = 8);
+
+    // Sets results[i] to whether the DFA accepts inputs[i]
+    void accepts(std::span<const std::string_view> inputs, uint8_t *results) const;
+
+    std::vector<uint8_t> accepts(std::span<const std::string_view> inputs) const {
+        std::vector<uint8_t> results(inputs.size());
+        accepts(inputs, results.data());
+        return results;
+    }
+
+    size_t get_lanes() const { return lanes; }
+
+    const CompiledDfa &dfa;
+
+private:
+    size_t lanes;
+};
@@ -0,0 +1,253 @@
+#include <cstring>
+#include "jit-compiled-dfa.hpp"
+
+#if defined(__x86_64__) && defined(__linux__)
+#define JIT_COMPILED_DFA_NATIVE 1
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef JIT_COMPILED_DFA_NATIVE
+
+namespace {
+
+// Positions of the code blocks, jumps are patched once all of them are known
+enum class JitLabelKind {
+    State, Accept, Reject
+};
+
+struct JitLabel {
+    JitLabelKind kind;
+    uint32_t state = 0;
+};
+
+struct JitFixup {
+    size_t position;
+    // The displacement is counted from here: the end of the instruction for
+    // jumps, the start of the table for the jump table entries
+    size_t base;
+    JitLabel label;
+};
+
+struct JitByteRange {
+    unsigned char low;
+    unsigned char high;
+    uint32_t target;
+};
+
+// Emits the matcher function, called as bool (*)(const unsigned char *begin,
+// const unsigned char *end) with the System V ABI: begin is in rdi, end in rsi
+class JitAssembler {
+public:
+    explicit JitAssembler(const CompiledDfa &dfa) : dfa(dfa), state_offsets(dfa.get_state_count(), 0) {}
+
+    std::vector<uint8_t> assemble() {
+        emit_jump(label_of(dfa.get_start_state()));
+
+        for (uint32_t state = 1; state < dfa.get_state_count(); state++) {
+            state_offsets[state] = code.size();
+            emit_state(state);
+        }
+
+        accept_offset = code.size();
+        emit({0xB8, 0x01, 0x00, 0x00, 0x00}); // mov eax, 1
+        emit({0xC3});                         // ret
+
+        reject_offset = code.size();
+        emit({0x31, 0xC0});                   // xor eax, eax
+        emit({0xC3});                         // ret
+
+        for (auto &fixup: fixups) {
+            int32_t displacement = static_cast<int32_t>(offset_of(fixup.label) - fixup.base);
+            std::memcpy(&code[fixup.position], &displacement, sizeof(displacement));
+        }
+
+        return std::move(code);
+    }
+
+private:
+    JitLabel label_of(uint32_t state) const {
+        if (state == CompiledDfa::dead_state) {
+            return {JitLabelKind::Reject};
+        }
+        return {JitLabelKind::State, state};
+    }
+
+    size_t offset_of(const JitLabel &label) const {
+        switch (label.kind) {
+            case JitLabelKind::State:
+                return state_offsets[label.state];
+            case JitLabelKind::Accept:
+                return accept_offset;
+            case JitLabelKind::Reject:
+                return reject_offset;
+        }
+        return reject_offset;
+    }
+
+    void emit(std::initializer_list<uint8_t> bytes) {
+        code.insert(code.end(), bytes);
+    }
+
+    void emit_int32(int32_t value) {
+        uint8_t bytes[sizeof(value)];
+        std::memcpy(bytes, &value, sizeof(value));
+        code.insert(code.end(), bytes, bytes + sizeof(value));
+    }
+
+    // Emits the rel32 of the instruction whose opcode was just written
+    void emit_target(const JitLabel &label) {
+        fixups.push_back({code.size(), code.size() + 4, label});
+        emit_int32(0);
+    }
+
+    void emit_jump(const JitLabel &label) {
+        emit({0xE9}); // jmp rel32
+        emit_target(label);
+    }
+
+    std::vector<JitByteRange> get_ranges(uint32_t state) const {
+        std::vector<JitByteRange> ranges;
+
+        for (size_t byte = 0; byte < 256; byte++) {
+            uint32_t target = dfa.step(state, static_cast<unsigned char>(byte));
+            if (!ranges.empty() && ranges.back().target == target && static_cast<size_t>(ranges.back().high) + 1 == byte) {
+                ranges.back().high = static_cast<unsigned char>(byte);
+            } else {
+                ranges.push_back({static_cast<unsigned char>(byte), static_cast<unsigned char>(byte), target});
+            }
+        }
+
+        // Everything else goes to the dead state, which is the fallthrough
+        std::erase_if(ranges, [](const JitByteRange &range) { return range.target == CompiledDfa::dead_state; });
+        return ranges;
+    }
+
+    void emit_state(uint32_t state) {
+        emit({0x48, 0x39, 0xF7});             // cmp rdi, rsi
+        emit({0x0F, 0x84});                   // je rel32
+        emit_target({dfa.is_final(state) ? JitLabelKind::Accept : JitLabelKind::Reject});
+
+        emit({0x0F, 0xB6, 0x07});             // movzx eax, byte [rdi]
+        emit({0x48, 0xFF, 0xC7});             // inc rdi
+
+        std::vector<JitByteRange> ranges = get_ranges(state);
+
+        if (ranges.size() > JitCompiledDfa::max_compare_ranges) {
+            emit_jump_table(state);
+            return;
+        }
+
+        for (auto &range: ranges) {
+            if (range.low == range.high) {
+                emit({0x3D});                 // cmp eax, imm32
+                emit_int32(range.low);
+                emit({0x0F, 0x84});           // je rel32
+            } else {
+                emit({0x8D, 0x88});           // lea ecx, [rax + disp32]
+                emit_int32(-static_cast<int32_t>(range.low));
+                emit({0x81, 0xF9});           // cmp ecx, imm32
+                emit_int32(range.high - range.low);
+                emit({0x0F, 0x86});           // jbe rel32
+            }
+            emit_target(label_of(range.target));
+        }
+
+        emit_jump({JitLabelKind::Reject});
+    }
+
+    void emit_jump_table(uint32_t state) {
+        emit({0x48, 0x8D, 0x0D});             // lea rcx, [rip + disp32]
+        emit_int32(0);
+        size_t table_displacement = code.size() - 4;
+
+        emit({0x48, 0x63, 0x14, 0x81});       // movsxd rdx, dword [rcx + rax * 4]
+        emit({0x48, 0x01, 0xCA});             // add rdx, rcx
+        emit({0xFF, 0xE2});                   // jmp rdx
+
+        size_t table = code.size();
+        int32_t displacement = static_cast<int32_t>(table - (table_displacement + 4));
+        std::memcpy(&code[table_displacement], &displacement, sizeof(displacement));
+
+        // Entries are relative to the start of the table
+        for (size_t byte = 0; byte < 256; byte++) {
+            fixups.push_back({code.size(), table, label_of(dfa.step(state, static_cast<unsigned char>(byte)))});
+            emit_int32(0);
+        }
+    }
+
+    const CompiledDfa &dfa;
+    std::vector<uint8_t> code;
+    std::vector<size_t> state_offsets;
+    std::vector<JitFixup> fixups;
+    size_t accept_offset = 0;
+    size_t reject_offset = 0;
+};
+
+}
+
+#endif
+
+JitCompiledDfa::JitCompiledDfa(const CompiledDfa &dfa) : dfa(dfa) {
+#ifdef JIT_COMPILED_DFA_NATIVE
+    std::vector<uint8_t> code = JitAssembler(dfa).assemble();
+
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t size = (code.size() + page_size - 1) / page_size * page_size;
+
+    void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return;
+    }
+
+    std::memcpy(memory, code.data(), code.size());
+
+    // The pages are never writable and executable at the same time
+    if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, size);
+        return;
+    }
+
+    pages = memory;
+    pages_size = size;
+    code_size = code.size();
+    function = reinterpret_cast<MatchFunction>(memory);
+#endif
+}
+
+JitCompiledDfa::JitCompiledDfa(JitCompiledDfa &&move) noexcept :
+        dfa(std::move(move.dfa)), function(move.function), pages(move.pages), pages_size(move.pages_size),
+        code_size(move.code_size) {
+    move.function = nullptr;
+    move.pages = nullptr;
+    move.pages_size = 0;
+    move.code_size = 0;
+}
+
+JitCompiledDfa &JitCompiledDfa::operator=(JitCompiledDfa &&move) noexcept {
+    if (this != &move) {
+        release();
+        dfa = std::move(move.dfa);
+        std::swap(function, move.function);
+        std::swap(pages, move.pages);
+        std::swap(pages_size, move.pages_size);
+        std::swap(code_size, move.code_size);
+    }
+    return *this;
+}
+
+JitCompiledDfa::~JitCompiledDfa() {
+    release();
+}
+
+void JitCompiledDfa::release() {
+#ifdef JIT_COMPILED_DFA_NATIVE
+    if (pages) {
+        munmap(pages, pages_size);
+    }
+#endif
+    function = nullptr;
+    pages = nullptr;
+    pages_size = 0;
+    code_size = 0;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "compiled-dfa.hpp"
+
+// Native code for a CompiledDfa, for the hottest patterns. Every state becomes
+// a block of x86-64 code which reads the next byte and jumps straight to the
+// block of the next state: through a chain of range compares when the state
+// has few distinct ranges of bytes, or through a jump table indexed by the
+// byte otherwise. The code is written to anonymous pages which are made
+// executable (and read-only) once it's complete.
+//
+// On other architectures, or when the pages can't be mapped, accepts() runs
+// the table of the CompiledDfa instead, so the class is always usable.
+
+class JitCompiledDfa {
+public:
+    // States with more byte ranges than this get a jump table
+    static constexpr size_t max_compare_ranges = 8;
+
+    explicit JitCompiledDfa(const CompiledDfa &dfa);
+
+    JitCompiledDfa(const JitCompiledDfa &) = delete;
+
+    JitCompiledDfa &operator=(const JitCompiledDfa &) = delete;
+
+    JitCompiledDfa(JitCompiledDfa &&move) noexcept;
+
+    JitCompiledDfa &operator=(JitCompiledDfa &&move) noexcept;
+
+    ~JitCompiledDfa();
+
+    bool accepts(std::string_view input) const {
+        if (function) {
+            auto begin = reinterpret_cast<const unsigned char *>(input.data());
+            return function(begin, begin + input.size());
+        }
+        return dfa.accepts(input);
+    }
+
+    // Whether accepts() runs native code
+    bool is_native() const { return function != nullptr; }
+
+    size_t get_code_size() const { return code_size; }
+
+    const CompiledDfa &get_dfa() const { return dfa; }
+
+private:
+    using MatchFunction = bool (*)(const unsigned char *begin, const unsigned char *end);
+
+    void release();
+
+    CompiledDfa dfa;
+    MatchFunction function = nullptr;
+    void *pages = nullptr;
+    size_t pages_size = 0;
+    size_t code_size = 0;
+};
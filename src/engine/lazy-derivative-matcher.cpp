@@ -0,0 +1 @@
+#include "lazy-derivative-matcher.hpp"
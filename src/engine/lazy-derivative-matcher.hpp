@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include "regex-derivative.hpp"
+
+// Matches input against a regex by walking its derivatives, building the DFA
+// lazily: a derivative is computed the first time some input reaches it with
+// a given byte, and the transition is memoized for all later inputs.
+// When the cache grows over max_cached_states it's flushed, keeping only the
+// state the input is currently in, so memory stays bounded on any pattern.
+
+class LazyDerivativeMatcher {
+public:
+    LazyDerivativeMatcher(const Regex &regex, size_t max_cached_states = SIZE_MAX) :
+            max_cached_states(std::max<size_t>(max_cached_states, 3)) {
+        regex.fill_alphabet(alphabet);
+        start_regex = RegexDerivative::normalize(regex);
+        flush_cache();
+    }
+
+    bool accepts(std::string_view input) {
+        size_t state = start_state;
+
+        for (char c: input) {
+            state = step(state, c);
+            if (state == zero_state) {
+                return false;
+            }
+        }
+
+        return is_final[state];
+    }
+
+    size_t step(size_t state, char c) {
+        int32_t target = transitions[state][static_cast<unsigned char>(c)];
+
+        if (target < 0) {
+            if (!alphabet.contains(c)) {
+                target = static_cast<int32_t>(zero_state);
+            } else {
+                if (states.size() >= max_cached_states) {
+                    state = flush_cache(std::move(states[state]));
+                }
+                target = static_cast<int32_t>(find_or_add_state(RegexDerivative::derive(states[state], c)));
+            }
+            // Adding a state might have moved the table
+            transitions[state][static_cast<unsigned char>(c)] = target;
+        }
+
+        return static_cast<size_t>(target);
+    }
+
+    size_t get_state_count() const { return states.size(); }
+
+    size_t get_start_state() const { return start_state; }
+
+    // No input leads out of it
+    size_t get_zero_state() const { return zero_state; }
+
+    bool is_final_state(size_t state) const { return is_final[state]; }
+
+    size_t get_flush_count() const { return flush_count; }
+
+private:
+    // Drops all the memoized states, except the dead and start ones and the
+    // given one. Returns the new index of the given state.
+    size_t flush_cache(std::optional<Regex> &&keep = std::nullopt) {
+        if (!states.empty()) {
+            flush_count++;
+        }
+
+        states.clear();
+        is_final.clear();
+        transitions.clear();
+        state_indices.clear();
+
+        zero_state = find_or_add_state(Regex::zero());
+        start_state = find_or_add_state(Regex(start_regex));
+
+        if (keep) {
+            return find_or_add_state(std::move(*keep));
+        }
+        return start_state;
+    }
+
+    size_t find_or_add_state(Regex &&derivative) {
+        auto it = state_indices.find(derivative);
+        if (it != state_indices.end()) {
+            return it->second;
+        }
+
+        size_t index = states.size();
+        is_final.push_back(RegexDerivative::is_nullable(derivative));
+        transitions.emplace_back();
+        transitions.back().fill(-1);
+        state_indices.emplace(derivative, index);
+        states.push_back(std::move(derivative));
+        return index;
+    }
+
+    std::set<char> alphabet;
+    Regex start_regex;
+    size_t max_cached_states;
+    size_t flush_count = 0;
+
+    std::vector<Regex> states;
+    std::vector<bool> is_final;
+    std::vector<std::array<int32_t, 256>> transitions;
+    std::unordered_map<Regex, size_t, RegexHash> state_indices;
+
+    size_t zero_state = 0;
+    size_t start_state = 0;
+};
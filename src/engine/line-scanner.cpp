@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <cstring>
+#include "line-scanner.hpp"
+#include "glushkov-automaton-builder.hpp"
+#include "pattern-searcher.hpp"
+#include "regex-literal-analyzer.hpp"
+
+LineScanner::LineScanner(const Regex &regex, LineMatchMode mode, bool use_prefilter,
+                         const PatternCompilerOptions &options) :
+        mode(mode), lazy_cache_states(options.lazy_cache_states) {
+    if (mode == LineMatchMode::Contains) {
+        std::optional<UnanchoredDfa> built = UnanchoredDfa::try_build(GlushkovAutomatonBuilder(regex).build(),
+                                                                      options.limits, options.control);
+        if (built) {
+            unanchored = std::move(*built);
+        } else {
+            lazy_regex = UnanchoredDfa::unanchored_regex(regex);
+            fallback_reason = "unanchored " + PatternCompiler::describe_fallback(options);
+        }
+    } else {
+        pattern = PatternCompiler(regex, options).compile();
+        if (pattern.get_engine() == PatternEngine::LazyDfa) {
+            lazy_regex = regex;
+            fallback_reason = pattern.get_stats().fallback_reason;
+        } else {
+            dfa = pattern.get_dfa();
+        }
+    }
+
+    if (use_prefilter) {
+        RegexLiterals literals = RegexLiteralAnalyzer(regex).analyze();
+        // A literal with a line break can't be in a line, the DFA rejects those lines anyway
+        if (literals.required.find('\n') == std::string::npos) {
+            literal = literals.required;
+        }
+    }
+}
+
+PatternEngine LineScanner::get_engine() const {
+    if (lazy_regex) {
+        return PatternEngine::LazyDfa;
+    }
+    return mode == LineMatchMode::Contains ? PatternEngine::Dfa : pattern.get_engine();
+}
+
+size_t LineScanner::get_start_state(const LazyDerivativeMatcher *lazy) const {
+    return lazy ? lazy->get_start_state() : get_dfa().get_start_state();
+}
+
+bool LineScanner::is_final(size_t state, const LazyDerivativeMatcher *lazy) const {
+    return lazy ? lazy->is_final_state(state) : get_dfa().is_final(static_cast<uint32_t>(state));
+}
+
+size_t LineScanner::run_line(size_t state, std::string_view part, LazyDerivativeMatcher *lazy) const {
+    if (lazy) {
+        for (char c: part) {
+            if (state == lazy->get_zero_state() || (mode == LineMatchMode::Contains && lazy->is_final_state(state))) {
+                break;
+            }
+            state = lazy->step(state, c);
+            // Σ*·regex only dies on a byte outside of the alphabet, which ends every match in progress
+            if (mode == LineMatchMode::Contains && state == lazy->get_zero_state()) {
+                state = lazy->get_start_state();
+            }
+        }
+        return state;
+    }
+
+    // The unanchored DFA only dies when the language is empty
+    if (mode == LineMatchMode::Contains) {
+        for (char c: part) {
+            if (unanchored.is_final(state) || state == CompiledDfa::dead_state) {
+                break;
+            }
+            state = unanchored.step(state, static_cast<unsigned char>(c));
+        }
+        return state;
+    }
+
+    for (char c: part) {
+        if (state == CompiledDfa::dead_state) {
+            break;
+        }
+        state = dfa.step(state, static_cast<unsigned char>(c));
+    }
+    return state;
+}
+
+size_t LineScanner::scan_complete_lines(std::string_view text, size_t offset, size_t &line_number,
+                                        std::vector<LineSpan> &out, LazyDerivativeMatcher *lazy) const {
+    auto last_newline = static_cast<const char *>(memrchr(text.data(), '\n', text.size()));
+    if (!last_newline) {
+        return 0;
+    }
+
+    std::string_view lines = text.substr(0, last_newline - text.data() + 1);
+    size_t cursor = 0;
+    bool use_pattern = get_engine() == PatternEngine::Jit || get_engine() == PatternEngine::Sheng;
+
+    while (cursor < lines.size()) {
+        if (!literal.empty()) {
+            // Jump to the line with the next occurrence of the literal
+            size_t found = PatternSearcher::find_literal(lines, cursor, literal);
+            size_t next = lines.size();
+
+            if (found != std::string_view::npos) {
+                auto newline = static_cast<const char *>(memrchr(lines.data() + cursor, '\n', found - cursor));
+                next = newline ? newline - lines.data() + 1 : cursor;
+            }
+
+            line_number += std::count(lines.begin() + cursor, lines.begin() + next, '\n');
+            cursor = next;
+            if (cursor == lines.size()) {
+                break;
+            }
+        }
+
+        auto newline = static_cast<const char *>(memchr(lines.data() + cursor, '\n', lines.size() - cursor));
+        size_t end = newline - lines.data();
+
+        std::string_view line = lines.substr(cursor, end - cursor);
+        bool is_match = use_pattern ? pattern.accepts(line)
+                                    : is_final(run_line(get_start_state(lazy), line, lazy), lazy);
+        if (is_match) {
+            out.push_back({offset + cursor, offset + end, line_number});
+        }
+        line_number++;
+        cursor = end + 1;
+    }
+
+    return lines.size();
+}
+
+std::vector<LineSpan> LineScanner::scan(std::string_view text) const {
+    std::vector<LineSpan> result;
+    LineScanStream stream(*this);
+    stream.feed(text, result);
+    stream.finish(result);
+    return result;
+}
+
+LineScanStream::LineScanStream(const LineScanner &scanner) : scanner(scanner) {
+    if (scanner.lazy_regex) {
+        lazy.emplace(*scanner.lazy_regex, scanner.lazy_cache_states);
+    }
+    state = scanner.get_start_state(lazy ? &*lazy : nullptr);
+}
+
+void LineScanStream::feed(std::string_view chunk, std::vector<LineSpan> &out) {
+    LazyDerivativeMatcher *matcher = lazy ? &*lazy : nullptr;
+    size_t position = 0;
+
+    // The line left unfinished by the previous chunk continues here
+    if (line_begin < offset) {
+        auto newline = static_cast<const char *>(memchr(chunk.data(), '\n', chunk.size()));
+        if (!newline) {
+            state = scanner.run_line(state, chunk, matcher);
+            offset += chunk.size();
+            return;
+        }
+
+        position = newline - chunk.data();
+        if (scanner.is_final(scanner.run_line(state, chunk.substr(0, position), matcher), matcher)) {
+            out.push_back({line_begin, offset + position, line_number});
+        }
+        line_number++;
+        position++;
+    }
+
+    std::string_view rest = chunk.substr(position);
+    size_t tail = scanner.scan_complete_lines(rest, offset + position, line_number, out, matcher);
+
+    line_begin = offset + position + tail;
+    state = scanner.run_line(scanner.get_start_state(matcher), rest.substr(tail), matcher);
+    offset += chunk.size();
+}
+
+void LineScanStream::finish(std::vector<LineSpan> &out) {
+    const LazyDerivativeMatcher *matcher = lazy ? &*lazy : nullptr;
+    if (line_begin < offset) {
+        if (scanner.is_final(state, matcher)) {
+            out.push_back({line_begin, offset, line_number});
+        }
+        line_number++;
+    }
+
+    line_begin = offset;
+    state = scanner.get_start_state(matcher);
+}
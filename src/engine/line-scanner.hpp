@@ -0,0 +1,128 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "compiled-dfa.hpp"
+#include "unanchored-dfa.hpp"
+#include "lazy-derivative-matcher.hpp"
+#include "pattern-compiler.hpp"
+#include "regex.hpp"
+
+enum class LineMatchMode {
+    // A line matches if it contains a word of the language
+    Contains,
+    // The whole line has to be a word of the language
+    Whole
+};
+
+// A matching line without its line break, number counts from 0
+struct LineSpan {
+    size_t begin;
+    size_t end;
+    size_t number;
+
+    bool operator==(const LineSpan &other) const = default;
+};
+
+// Finds the lines of a text which match a regex, in one pass over the text
+// and without cutting it into strings. The DFA is reset at every line break,
+// and the line ends found with memchr let it skip the rest of a line once
+// its result is known: after the dead state in the Whole mode, or after a
+// final state of the UnanchoredDfa in the Contains mode. Lines without a
+// literal every match must contain are skipped with memmem, only counting
+// their line breaks.
+//
+// In the Whole mode the lines are matched by the engine PatternCompiler
+// picks, so a line which is known in full runs on the JIT or the shuffle
+// matcher when the options and the DFA allow that. The table only carries
+// the lines across the chunks of a stream, and the Contains mode always
+// uses it, as the other engines only tell the state at the end of a line.
+//
+// The DFAs are only built within PatternCompilerOptions::limits. Past them
+// both modes fall back to a lazy derivative DFA with a bounded cache: of the
+// regex in the Whole mode, and of Σ*·regex in the Contains mode, which
+// restarts after the bytes outside of the alphabet just like the
+// UnanchoredDfa. Its cache can't be shared, so every LineScanStream runs a
+// matcher of its own, which also carries the lines across the chunks.
+
+class LineScanner {
+public:
+    explicit LineScanner(const Regex &regex, LineMatchMode mode = LineMatchMode::Contains,
+                         bool use_prefilter = true, const PatternCompilerOptions &options = {});
+
+    // The last line doesn't need a line break, an empty one after the last
+    // line break isn't counted
+    std::vector<LineSpan> scan(std::string_view text) const;
+
+    LineMatchMode get_mode() const { return mode; }
+
+    // The engine which matches the lines that don't cross chunk borders
+    PatternEngine get_engine() const;
+
+    // Why the lines are matched by the lazy DFA, empty when they aren't
+    const std::string &get_fallback_reason() const { return fallback_reason; }
+
+    // Only meaningful when the engine isn't LazyDfa
+    const CompiledDfa &get_dfa() const { return mode == LineMatchMode::Contains ? unanchored.get_dfa() : dfa; }
+
+    // Empty when every line is run through the DFA
+    const std::string &get_literal() const { return literal; }
+
+private:
+    friend class LineScanStream;
+
+    // The states of a line are the ones of the lazy matcher of the stream
+    // after a fallback, and the ones of the DFA otherwise
+    size_t get_start_state(const LazyDerivativeMatcher *lazy) const;
+
+    bool is_final(size_t state, const LazyDerivativeMatcher *lazy) const;
+
+    // Continues a line from the given state, stops as soon as its result is known
+    size_t run_line(size_t state, std::string_view part, LazyDerivativeMatcher *lazy) const;
+
+    // Scans the lines of the text which end with a line break, the text
+    // starts at offset in the whole input. Returns the start of the rest.
+    size_t scan_complete_lines(std::string_view text, size_t offset, size_t &line_number,
+                               std::vector<LineSpan> &out, LazyDerivativeMatcher *lazy) const;
+
+    LineMatchMode mode;
+    // Only the ones for the mode are built
+    CompiledDfa dfa;
+    CompiledPattern pattern;
+    UnanchoredDfa unanchored;
+    // What the streams match with their lazy matchers, after a fallback
+    std::optional<Regex> lazy_regex;
+    size_t lazy_cache_states;
+    std::string fallback_reason;
+    std::string literal;
+};
+
+// Scans a text which arrives in chunks, lines may cross the chunk borders.
+// Only the DFA state of the unfinished line is kept between the chunks, not
+// its bytes, and the spans are offsets from the start of the whole text.
+
+class LineScanStream {
+public:
+    explicit LineScanStream(const LineScanner &scanner);
+
+    // Appends the matching lines which end in the chunk
+    void feed(std::string_view chunk, std::vector<LineSpan> &out);
+
+    // Ends the last line when the text doesn't end with a line break
+    void finish(std::vector<LineSpan> &out);
+
+    // Where the unfinished line starts, the bytes before it aren't needed anymore
+    size_t get_line_begin() const { return line_begin; }
+
+    size_t get_line_count() const { return line_number; }
+
+private:
+    const LineScanner &scanner;
+    size_t offset = 0;
+    size_t line_begin = 0;
+    size_t line_number = 0;
+    std::optional<LazyDerivativeMatcher> lazy;
+    size_t state;
+};
@@ -0,0 +1,166 @@
+#include <algorithm>
+#include "parallel-automaton-determinator.hpp"
+
+FiniteAutomaton ParallelAutomatonDeterminator::determine() {
+    assert(!automaton.has_epsilon_transitions());
+    assert(automaton.is_simple());
+
+    prepare_transition_table();
+
+    std::vector<bool> is_final;
+    std::vector<std::vector<std::pair<uint8_t, uint32_t>>> transitions;
+
+    ParallelSuperposition start = {static_cast<uint32_t>(automaton.get_start_state_index())};
+    std::vector<FrontierItem> frontier = {{superpositions.find_or_add(start).first, start, {}}};
+    is_final.push_back(is_final_superposition(start));
+
+    size_t thread_count = pool.get_thread_count();
+    std::vector<std::vector<FrontierItem>> next_frontiers(thread_count);
+    std::vector<std::vector<uint32_t>> marks(thread_count, std::vector<uint32_t>(automaton.get_states().size(), 0));
+    std::vector<uint32_t> mark_values(thread_count, 0);
+
+    while (!frontier.empty()) {
+        pool.parallel_for(frontier.size(), [&](size_t index, size_t thread_index) {
+            expand(frontier[index], next_frontiers[thread_index], marks[thread_index], mark_values[thread_index]);
+        }, 16);
+
+        size_t state_count = superpositions.size();
+        is_final.resize(state_count);
+        transitions.resize(state_count);
+
+        for (auto &item: frontier) {
+            transitions[item.id] = std::move(item.transitions);
+        }
+
+        frontier.clear();
+        for (auto &next_frontier: next_frontiers) {
+            for (auto &item: next_frontier) {
+                is_final[item.id] = is_final_superposition(item.states);
+                frontier.push_back(std::move(item));
+            }
+            next_frontier.clear();
+        }
+    }
+
+    return build_canonical(is_final, transitions);
+}
+
+void ParallelAutomatonDeterminator::prepare_transition_table() {
+    std::set<char> alphabet = automaton.alphabet;
+    for (auto &state: automaton.get_states()) {
+        for (auto &transition: state.transitions) {
+            alphabet.insert(CharRegex::get_char(transition.regex));
+        }
+    }
+    letters.assign(alphabet.begin(), alphabet.end());
+
+    size_t letter_count = letters.size();
+    auto &states = automaton.get_states();
+
+    std::array<int, 256> letter_indices{};
+    for (size_t i = 0; i < letter_count; i++) {
+        letter_indices[static_cast<unsigned char>(letters[i])] = static_cast<int>(i);
+    }
+
+    offsets.assign(states.size() * letter_count + 1, 0);
+    for (size_t i = 0; i < states.size(); i++) {
+        for (auto &transition: states[i].transitions) {
+            size_t letter = letter_indices[static_cast<unsigned char>(CharRegex::get_char(transition.regex))];
+            offsets[i * letter_count + letter + 1]++;
+        }
+    }
+
+    for (size_t i = 1; i < offsets.size(); i++) {
+        offsets[i] += offsets[i - 1];
+    }
+
+    targets.resize(offsets.back());
+    std::vector<size_t> positions(offsets.begin(), offsets.end() - 1);
+
+    for (size_t i = 0; i < states.size(); i++) {
+        for (auto &transition: states[i].transitions) {
+            size_t letter = letter_indices[static_cast<unsigned char>(CharRegex::get_char(transition.regex))];
+            targets[positions[i * letter_count + letter]++] = static_cast<uint32_t>(transition.target_index);
+        }
+    }
+}
+
+void ParallelAutomatonDeterminator::expand(FrontierItem &item, std::vector<FrontierItem> &next_frontier,
+                                           std::vector<uint32_t> &marks, uint32_t &mark) {
+    size_t letter_count = letters.size();
+    ParallelSuperposition successor;
+
+    for (size_t letter = 0; letter < letter_count; letter++) {
+        successor.clear();
+        mark++;
+
+        for (uint32_t state: item.states) {
+            size_t begin = offsets[state * letter_count + letter];
+            size_t end = offsets[state * letter_count + letter + 1];
+
+            for (size_t i = begin; i < end; i++) {
+                uint32_t target = targets[i];
+                if (marks[target] != mark) {
+                    marks[target] = mark;
+                    successor.push_back(target);
+                }
+            }
+        }
+
+        if (successor.empty()) {
+            continue;
+        }
+
+        std::sort(successor.begin(), successor.end());
+
+        auto [id, is_new] = superpositions.find_or_add(successor);
+        item.transitions.emplace_back(static_cast<uint8_t>(letter), id);
+
+        if (is_new) {
+            next_frontier.push_back({id, successor, {}});
+        }
+    }
+}
+
+bool ParallelAutomatonDeterminator::is_final_superposition(const ParallelSuperposition &states) const {
+    for (uint32_t state: states) {
+        if (automaton.get_states()[state].is_final) {
+            return true;
+        }
+    }
+    return false;
+}
+
+FiniteAutomaton ParallelAutomatonDeterminator::build_canonical(
+        const std::vector<bool> &is_final,
+        const std::vector<std::vector<std::pair<uint8_t, uint32_t>>> &transitions) const {
+    // Transitions of every superposition are already sorted by letter,
+    // so the breadth-first order only depends on the language structure
+    std::vector<int64_t> canonical(is_final.size(), -1);
+    std::vector<uint32_t> order = {0};
+    canonical[0] = 0;
+
+    for (size_t position = 0; position < order.size(); position++) {
+        for (auto &[letter, target]: transitions[order[position]]) {
+            if (canonical[target] == -1) {
+                canonical[target] = static_cast<int64_t>(order.size());
+                order.push_back(target);
+            }
+        }
+    }
+
+    FiniteAutomaton result;
+    result.extend_alphabet(automaton.alphabet);
+
+    for (uint32_t id: order) {
+        result.add_state(is_final[id]);
+    }
+
+    for (size_t index = 0; index < order.size(); index++) {
+        for (auto &[letter, target]: transitions[order[index]]) {
+            result.add_transition(index, canonical[target], Regex(CharRegex(letters[letter])));
+        }
+    }
+
+    return result;
+}
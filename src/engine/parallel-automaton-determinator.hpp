@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <unordered_map>
+#include "finite-automaton.hpp"
+#include "thread-pool.hpp"
+
+using ParallelSuperposition = std::vector<uint32_t>;
+
+struct ParallelSuperpositionHash {
+    size_t operator()(const ParallelSuperposition &superposition) const {
+        size_t hash = 14695981039346656037ULL;
+        for (uint32_t state: superposition) {
+            hash = (hash ^ state) * 1099511628211ULL;
+        }
+        return hash;
+    }
+};
+
+// Superpositions found so far, split into independently locked shards
+class ConcurrentSuperpositionMap {
+public:
+    // Returns the id of the superposition and whether it has just been added
+    std::pair<uint32_t, bool> find_or_add(const ParallelSuperposition &superposition) {
+        size_t hash = ParallelSuperpositionHash()(superposition);
+        auto &shard = shards[(hash >> 7) % shard_count];
+
+        std::lock_guard lock(shard.mutex);
+        auto it = shard.ids.find(superposition);
+        if (it != shard.ids.end()) {
+            return {it->second, false};
+        }
+
+        uint32_t id = next_id.fetch_add(1);
+        shard.ids.emplace(superposition, id);
+        return {id, true};
+    }
+
+    size_t size() const { return next_id; }
+
+private:
+    static constexpr size_t shard_count = 64;
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<ParallelSuperposition, uint32_t, ParallelSuperpositionHash> ids;
+    };
+
+    std::array<Shard, shard_count> shards;
+    std::atomic<uint32_t> next_id = 0;
+};
+
+// Creates DFA from simplified FA w/o epsilon-transitions on several threads.
+// The subset construction goes level by level: threads pull unexpanded
+// superpositions from the shared frontier, compute their successors locally
+// and intern the new ones in a concurrent map. Ids handed out by the map
+// depend on the thread timing, so the result is renumbered in breadth-first
+// order from the start state, which makes it identical between runs.
+// Empty superpositions are not created: partial input gives partial output.
+
+class ParallelAutomatonDeterminator {
+public:
+    ParallelAutomatonDeterminator(const FiniteAutomaton &automaton, ThreadPool &pool) :
+            automaton(automaton), pool(pool) {}
+
+    FiniteAutomaton determine();
+
+    const FiniteAutomaton &automaton;
+    ThreadPool &pool;
+
+private:
+    struct FrontierItem {
+        uint32_t id;
+        ParallelSuperposition states;
+        std::vector<std::pair<uint8_t, uint32_t>> transitions;
+    };
+
+    void prepare_transition_table();
+
+    void expand(FrontierItem &item, std::vector<FrontierItem> &next_frontier, std::vector<uint32_t> &marks,
+                uint32_t &mark);
+
+    FiniteAutomaton build_canonical(const std::vector<bool> &is_final,
+                                    const std::vector<std::vector<std::pair<uint8_t, uint32_t>>> &transitions) const;
+
+    bool is_final_superposition(const ParallelSuperposition &states) const;
+
+    std::vector<char> letters;
+
+    // Targets of state s by letter l are targets[offsets[s * L + l] .. offsets[s * L + l + 1])
+    std::vector<size_t> offsets;
+    std::vector<uint32_t> targets;
+
+    ConcurrentSuperpositionMap superpositions;
+};
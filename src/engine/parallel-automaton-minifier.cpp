@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <unordered_map>
+#include "parallel-automaton-minifier.hpp"
+
+FiniteAutomaton ParallelAutomatonMinifier::minify() {
+    // The implicit dead state takes part in the refinement as the last state
+    state_count = automaton.get_states().size() + 1;
+    letters.assign(automaton.alphabet.begin(), automaton.alphabet.end());
+
+    prepare_transition_table();
+
+    classes.resize(state_count);
+    next_classes.resize(state_count);
+    hashes.resize(state_count);
+
+    pool.parallel_for(state_count, [&](size_t state, size_t) {
+        classes[state] = state != get_dead_state() && automaton.get_states()[state].is_final ? 1 : 0;
+    }, 1024);
+
+    size_t class_count;
+
+    while (true) {
+        class_count = refine();
+        std::swap(classes, next_classes);
+
+        if (classes == next_classes) {
+            break;
+        }
+    }
+
+    return build_result(class_count);
+}
+
+void ParallelAutomatonMinifier::prepare_transition_table() {
+    size_t letter_count = letters.size();
+    size_t dead_state = get_dead_state();
+    targets.assign(state_count * letter_count, static_cast<uint32_t>(dead_state));
+    std::atomic<bool> found_missing = false;
+
+    pool.parallel_for(dead_state, [&](size_t state, size_t) {
+        for (size_t letter = 0; letter < letter_count; letter++) {
+            int transition_index = automaton.find_transition(letters[letter], state);
+
+            if (transition_index == -1) {
+                found_missing = true;
+            } else {
+                targets[state * letter_count + letter] =
+                        static_cast<uint32_t>(automaton.get_transition(state, transition_index).target_index);
+            }
+        }
+    }, 256);
+
+    is_partial = found_missing;
+}
+
+size_t ParallelAutomatonMinifier::get_signature_hash(size_t state) const {
+    size_t letter_count = letters.size();
+    size_t hash = 14695981039346656037ULL ^ classes[state];
+
+    for (size_t letter = 0; letter < letter_count; letter++) {
+        hash = (hash * 1099511628211ULL) ^ classes[targets[state * letter_count + letter]];
+    }
+
+    return hash * 0x9e3779b97f4a7c15ULL;
+}
+
+bool ParallelAutomatonMinifier::signatures_equal(size_t left, size_t right) const {
+    if (classes[left] != classes[right]) {
+        return false;
+    }
+
+    size_t letter_count = letters.size();
+    for (size_t letter = 0; letter < letter_count; letter++) {
+        if (classes[targets[left * letter_count + letter]] != classes[targets[right * letter_count + letter]]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ParallelAutomatonMinifier::signature_less(size_t left, size_t right) const {
+    if (classes[left] != classes[right]) {
+        return classes[left] < classes[right];
+    }
+
+    size_t letter_count = letters.size();
+    for (size_t letter = 0; letter < letter_count; letter++) {
+        uint32_t left_class = classes[targets[left * letter_count + letter]];
+        uint32_t right_class = classes[targets[right * letter_count + letter]];
+        if (left_class != right_class) {
+            return left_class < right_class;
+        }
+    }
+
+    return false;
+}
+
+size_t ParallelAutomatonMinifier::refine() {
+    size_t thread_count = pool.get_thread_count();
+    size_t shard_count = thread_count * 4;
+    size_t block_size = 4096;
+    size_t block_count = (state_count + block_size - 1) / block_size;
+
+    // Hash the signatures and scatter the states into shards by hash
+    std::vector<std::vector<std::vector<uint32_t>>> block_shards(block_count,
+                                                                 std::vector<std::vector<uint32_t>>(shard_count));
+
+    pool.parallel_for(block_count, [&](size_t block, size_t) {
+        size_t end = std::min(state_count, (block + 1) * block_size);
+        for (size_t state = block * block_size; state < end; state++) {
+            hashes[state] = get_signature_hash(state);
+            block_shards[block][hashes[state] % shard_count].push_back(static_cast<uint32_t>(state));
+        }
+    });
+
+    // Group equal signatures inside every shard. Every group is represented by its first state.
+    std::vector<std::vector<uint32_t>> shard_representatives(shard_count);
+    std::vector<uint32_t> group_of_state(state_count);
+
+    auto hash = [&](uint32_t state) { return hashes[state]; };
+    auto equal = [&](uint32_t left, uint32_t right) { return signatures_equal(left, right); };
+
+    pool.parallel_for(shard_count, [&](size_t shard, size_t) {
+        std::unordered_map<uint32_t, uint32_t, decltype(hash), decltype(equal)> groups(16, hash, equal);
+        auto &representatives = shard_representatives[shard];
+
+        for (auto &block: block_shards) {
+            for (uint32_t state: block[shard]) {
+                auto [it, inserted] = groups.emplace(state, static_cast<uint32_t>(representatives.size()));
+                if (inserted) {
+                    representatives.push_back(state);
+                }
+                group_of_state[state] = it->second;
+            }
+        }
+    });
+
+    // Number the groups in the sorted order of their signatures
+    std::vector<size_t> shard_offsets(shard_count + 1, 0);
+    for (size_t shard = 0; shard < shard_count; shard++) {
+        shard_offsets[shard + 1] = shard_offsets[shard] + shard_representatives[shard].size();
+    }
+
+    size_t group_count = shard_offsets.back();
+    std::vector<uint32_t> order(group_count);
+    std::vector<uint32_t> representatives(group_count);
+
+    for (size_t shard = 0; shard < shard_count; shard++) {
+        std::copy(shard_representatives[shard].begin(), shard_representatives[shard].end(),
+                  representatives.begin() + static_cast<long>(shard_offsets[shard]));
+    }
+
+    for (size_t group = 0; group < group_count; group++) {
+        order[group] = static_cast<uint32_t>(group);
+    }
+
+    std::sort(order.begin(), order.end(), [&](uint32_t left, uint32_t right) {
+        return signature_less(representatives[left], representatives[right]);
+    });
+
+    std::vector<uint32_t> group_rank(group_count);
+    for (size_t rank = 0; rank < group_count; rank++) {
+        group_rank[order[rank]] = static_cast<uint32_t>(rank);
+    }
+
+    pool.parallel_for(block_count, [&](size_t block, size_t) {
+        size_t end = std::min(state_count, (block + 1) * block_size);
+        for (size_t state = block * block_size; state < end; state++) {
+            size_t shard = hashes[state] % shard_count;
+            next_classes[state] = group_rank[shard_offsets[shard] + group_of_state[state]];
+        }
+    });
+
+    return group_count;
+}
+
+FiniteAutomaton ParallelAutomatonMinifier::build_result(size_t class_count) const {
+    size_t dead_state = get_dead_state();
+    uint32_t dead_class = classes[dead_state];
+    uint32_t start_class = classes[automaton.get_start_state_index()];
+
+    std::vector<int64_t> representatives(class_count, -1);
+    bool dead_class_has_states = false;
+
+    for (size_t state = 0; state < dead_state; state++) {
+        if (representatives[classes[state]] == -1) {
+            representatives[classes[state]] = static_cast<int64_t>(state);
+        }
+        if (classes[state] == dead_class) {
+            dead_class_has_states = true;
+        }
+    }
+
+    // Same rules as in AutomatonMinifier
+    bool drop_dead_class = dead_class != start_class && (is_partial || !dead_class_has_states);
+
+    FiniteAutomaton result;
+    result.extend_alphabet(automaton.alphabet);
+
+    std::vector<int64_t> result_nodes(class_count, -1);
+    for (size_t cls = 0; cls < class_count; cls++) {
+        if (!drop_dead_class || cls != dead_class) {
+            result_nodes[cls] = static_cast<int64_t>(result.add_state(false));
+        }
+    }
+
+    for (size_t state = 0; state < dead_state; state++) {
+        if (automaton.get_states()[state].is_final) {
+            result.make_state_final(result_nodes[classes[state]], true);
+        }
+    }
+
+    result.set_start_state(result_nodes[start_class]);
+
+    size_t letter_count = letters.size();
+    for (size_t cls = 0; cls < class_count; cls++) {
+        if (result_nodes[cls] == -1) continue;
+
+        // Only the dead class can be represented by the dead state alone
+        size_t state = representatives[cls] == -1 ? dead_state : representatives[cls];
+
+        for (size_t letter = 0; letter < letter_count; letter++) {
+            uint32_t target_class = classes[targets[state * letter_count + letter]];
+            if (is_partial && target_class == dead_class) continue;
+
+            result.add_transition(result_nodes[cls], result_nodes[target_class], Regex(CharRegex(letters[letter])));
+        }
+    }
+
+    return result;
+}
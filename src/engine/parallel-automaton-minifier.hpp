@@ -0,0 +1,46 @@
+#pragma once
+
+#include "finite-automaton.hpp"
+#include "thread-pool.hpp"
+
+// Minimizes a DFA like AutomatonMinifier, on several threads.
+// Every round computes the signature of each state (its class and the
+// classes of its targets, letter by letter) with a parallel loop, groups
+// equal signatures in hash shards processed in parallel, and numbers the
+// groups in the sorted order of their signatures. The numbering is the
+// same as in the serial minifier, so both produce identical automata.
+
+class ParallelAutomatonMinifier {
+public:
+    ParallelAutomatonMinifier(const FiniteAutomaton &automaton, ThreadPool &pool) : automaton(automaton), pool(pool) {}
+
+    FiniteAutomaton minify();
+
+    const FiniteAutomaton &automaton;
+    ThreadPool &pool;
+
+private:
+    void prepare_transition_table();
+
+    // Computes next_classes from classes, returns the number of classes
+    size_t refine();
+
+    size_t get_signature_hash(size_t state) const;
+
+    bool signatures_equal(size_t left, size_t right) const;
+
+    bool signature_less(size_t left, size_t right) const;
+
+    FiniteAutomaton build_result(size_t class_count) const;
+
+    size_t get_dead_state() const { return state_count - 1; }
+
+    size_t state_count = 0;
+    bool is_partial = false;
+    std::vector<char> letters;
+    std::vector<uint32_t> targets;
+
+    std::vector<uint32_t> classes;
+    std::vector<uint32_t> next_classes;
+    std::vector<size_t> hashes;
+};
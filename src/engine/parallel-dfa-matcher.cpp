@@ -0,0 +1,166 @@
+#include <algorithm>
+#include "parallel-dfa-matcher.hpp"
+
+std::vector<uint32_t> ParallelDfaMatcher::run_from_states(std::string_view chunk,
+                                                          const std::vector<uint32_t> &starts) const {
+    // Distinct current states, and which of them each start state is in
+    std::vector<uint32_t> current = starts;
+    std::vector<uint32_t> owners(starts.size());
+    for (size_t i = 0; i < starts.size(); i++) {
+        owners[i] = static_cast<uint32_t>(i);
+    }
+
+    std::vector<int32_t> slots(dfa.get_state_count(), -1);
+    std::vector<uint32_t> merged;
+    std::vector<uint32_t> remap;
+
+    // Runs which meet in the same state stay together from then on
+    constexpr size_t block = 256;
+
+    for (size_t offset = 0; offset < chunk.size(); offset += block) {
+        std::string_view part = chunk.substr(offset, block);
+
+        if (current.size() <= 1) {
+            for (auto &state: current) {
+                state = dfa.run(state, chunk.substr(offset));
+            }
+            break;
+        }
+
+        for (char c: part) {
+            for (auto &state: current) {
+                state = dfa.step(state, static_cast<unsigned char>(c));
+            }
+        }
+
+        merged.clear();
+        remap.resize(current.size());
+        for (size_t i = 0; i < current.size(); i++) {
+            if (slots[current[i]] == -1) {
+                slots[current[i]] = static_cast<int32_t>(merged.size());
+                merged.push_back(current[i]);
+            }
+            remap[i] = static_cast<uint32_t>(slots[current[i]]);
+        }
+        for (uint32_t state: merged) {
+            slots[state] = -1;
+        }
+        for (auto &owner: owners) {
+            owner = remap[owner];
+        }
+        std::swap(current, merged);
+    }
+
+    std::vector<uint32_t> result(starts.size());
+    for (size_t i = 0; i < starts.size(); i++) {
+        result[i] = current[owners[i]];
+    }
+    return result;
+}
+
+uint32_t ParallelDfaMatcher::run_full_maps(const std::vector<std::string_view> &chunks) const {
+    size_t state_count = dfa.get_state_count();
+
+    // The dead state never leaves itself, and leaving it out lets the runs
+    // from the other states converge to a single one
+    std::vector<uint32_t> live_states;
+    for (uint32_t state = 1; state < state_count; state++) {
+        live_states.push_back(state);
+    }
+
+    // maps[i][s] is the state after chunks [0, i] when chunk 0 starts in s
+    std::vector<std::vector<uint32_t>> maps(chunks.size());
+    pool.parallel_for(chunks.size(), [&](size_t i, size_t) {
+        maps[i] = run_from_states(chunks[i], live_states);
+        maps[i].insert(maps[i].begin(), CompiledDfa::dead_state);
+    });
+
+    // Hillis-Steele scan: after the round with the given distance, every map
+    // covers the chunks back to i - 2 * distance + 1
+    std::vector<std::vector<uint32_t>> next(chunks.size());
+    for (size_t distance = 1; distance < chunks.size(); distance *= 2) {
+        pool.parallel_for(chunks.size(), [&](size_t i, size_t) {
+            if (i < distance) {
+                next[i] = maps[i];
+                return;
+            }
+            next[i].resize(state_count);
+            for (size_t state = 0; state < state_count; state++) {
+                next[i][state] = maps[i][maps[i - distance][state]];
+            }
+        });
+        std::swap(maps, next);
+    }
+
+    return maps.back()[dfa.get_start_state()];
+}
+
+uint32_t ParallelDfaMatcher::run_guessed(std::string_view input, const std::vector<std::string_view> &chunks,
+                                         ParallelDfaMatchStats *stats) const {
+    // Evenly spread states to run the lookback from, next to the start state
+    std::vector<uint32_t> seeds = {dfa.get_start_state()};
+    size_t state_count = dfa.get_state_count();
+    for (size_t i = 1; i < max_guessed_states; i++) {
+        seeds.push_back(static_cast<uint32_t>(1 + (i * (state_count - 1)) / max_guessed_states));
+    }
+
+    std::vector<std::vector<uint32_t>> guesses(chunks.size());
+    std::vector<std::vector<uint32_t>> ends(chunks.size());
+
+    pool.parallel_for(chunks.size(), [&](size_t i, size_t) {
+        if (i == 0) {
+            guesses[i] = {dfa.get_start_state()};
+        } else {
+            // The DFA mostly forgets where it started after a while, so the
+            // runs over the bytes before the chunk end in only a few states
+            size_t begin = chunks[i].data() - input.data();
+            size_t from = begin > lookback ? begin - lookback : 0;
+            std::string_view before = input.substr(from, begin - from);
+
+            for (uint32_t seed: seeds) {
+                uint32_t guess = from == 0 ? dfa.run(dfa.get_start_state(), before) : dfa.run(seed, before);
+                if (std::find(guesses[i].begin(), guesses[i].end(), guess) == guesses[i].end()) {
+                    guesses[i].push_back(guess);
+                }
+            }
+        }
+        ends[i] = run_from_states(chunks[i], guesses[i]);
+    });
+
+    uint32_t state = dfa.get_start_state();
+    for (size_t i = 0; i < chunks.size(); i++) {
+        auto it = std::find(guesses[i].begin(), guesses[i].end(), state);
+        if (it != guesses[i].end()) {
+            state = ends[i][it - guesses[i].begin()];
+        } else {
+            state = dfa.run(state, chunks[i]);
+            if (stats) {
+                stats->mispredictions++;
+            }
+        }
+    }
+    return state;
+}
+
+uint32_t ParallelDfaMatcher::run(std::string_view input, ParallelDfaMatchStats *stats) const {
+    size_t thread_count = pool.get_thread_count();
+    size_t chunk_size = std::max(min_chunk_size, (input.size() + thread_count * 4 - 1) / (thread_count * 4));
+
+    std::vector<std::string_view> chunks;
+    for (size_t offset = 0; offset < input.size(); offset += chunk_size) {
+        chunks.push_back(input.substr(offset, chunk_size));
+    }
+
+    bool full_maps = dfa.get_state_count() <= max_full_states;
+    if (stats) {
+        *stats = {chunks.size(), full_maps, 0};
+    }
+
+    if (chunks.size() <= 1) {
+        return dfa.run(dfa.get_start_state(), input);
+    }
+    if (full_maps) {
+        return run_full_maps(chunks);
+    }
+    return run_guessed(input, chunks, stats);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "compiled-dfa.hpp"
+#include "thread-pool.hpp"
+
+struct ParallelDfaMatchStats {
+    size_t chunks = 0;
+    bool used_full_maps = false;
+    // Chunks whose incoming state wasn't among the guessed ones and were run again
+    size_t mispredictions = 0;
+};
+
+// Runs a CompiledDfa over one large buffer on all the threads of a pool. The
+// buffer is split into chunks, and every chunk but the first one is run from
+// several states at once, since the state it starts in isn't known yet. That
+// gives a map from the start states of the chunk to its end states.
+//
+// Small and medium DFAs (up to max_full_states) run every chunk from all the
+// states. The runs quickly converge, so after a few hundred bytes there are
+// usually only a couple of distinct states left to step. The full maps are
+// then composed with a parallel prefix scan, which gives the state at every
+// chunk boundary and the same final state as a sequential run.
+//
+// Larger DFAs only run a chunk from a few likely states, found by running the
+// DFA over the bytes right before the chunk from several seed states. The
+// guesses are checked in order, and a chunk whose incoming state wasn't among
+// them is run again from the right state.
+
+class ParallelDfaMatcher {
+public:
+    ParallelDfaMatcher(const CompiledDfa &dfa, ThreadPool &pool, size_t min_chunk_size = 1 << 16,
+                       size_t max_full_states = 256) :
+            dfa(dfa), pool(pool), min_chunk_size(std::max<size_t>(min_chunk_size, 1)),
+            max_full_states(max_full_states) {}
+
+    // The state the DFA ends in after reading the input
+    uint32_t run(std::string_view input, ParallelDfaMatchStats *stats = nullptr) const;
+
+    bool accepts(std::string_view input) const { return dfa.is_final(run(input)); }
+
+    // Bytes before a chunk to run the DFA over when guessing its incoming state
+    static constexpr size_t lookback = 1024;
+    // Seed states to run the lookback from
+    static constexpr size_t max_guessed_states = 4;
+
+    const CompiledDfa &dfa;
+    ThreadPool &pool;
+    size_t min_chunk_size;
+    size_t max_full_states;
+
+private:
+    // The end state of the chunk for each of the start states
+    std::vector<uint32_t> run_from_states(std::string_view chunk, const std::vector<uint32_t> &starts) const;
+
+    uint32_t run_full_maps(const std::vector<std::string_view> &chunks) const;
+
+    uint32_t run_guessed(std::string_view input, const std::vector<std::string_view> &chunks,
+                         ParallelDfaMatchStats *stats) const;
+};
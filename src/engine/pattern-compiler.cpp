@@ -0,0 +1,74 @@
+#include <sstream>
+#include "pattern-compiler.hpp"
+#include "glushkov-automaton-builder.hpp"
+#include "automaton-minifier.hpp"
+#include "automaton-optimizer.hpp"
+
+std::string PatternCompiler::describe_fallback(const PatternCompilerOptions &options) {
+    if (options.control && options.control->is_stopped()) {
+        switch (options.control->get_stop_reason()) {
+            case PipelineStopReason::Cancelled:
+                return "compilation was cancelled";
+            case PipelineStopReason::DeadlineExceeded:
+                return "compilation exceeded the deadline";
+            default:
+                return "";
+        }
+    }
+
+    std::stringstream reason;
+    reason << "determinization exceeded the limits of " << options.limits.max_states << " states, "
+           << options.limits.max_transitions << " transitions or " << options.limits.max_bytes << " bytes";
+    return reason.str();
+}
+
+void PatternCompiler::fall_back(CompiledPattern &pattern, std::string reason) {
+    pattern.stats.engine = PatternEngine::LazyDfa;
+    pattern.stats.fallback_reason = std::move(reason);
+    pattern.lazy_matcher.emplace(regex, options.lazy_cache_states);
+}
+
+CompiledPattern PatternCompiler::compile() {
+    CompiledPattern pattern;
+
+    FiniteAutomaton automaton = GlushkovAutomatonBuilder(regex).build();
+    AutomatonOptimizer(automaton).trim();
+    pattern.stats.nfa_states = automaton.get_states().size();
+
+    AutomatonDeterminator determinator(automaton, options.limits, options.control);
+    std::optional<FiniteAutomaton> dfa = determinator.try_determine();
+
+    if (!dfa) {
+        fall_back(pattern, describe_fallback(options));
+        return pattern;
+    }
+
+    AutomatonOptimizer(*dfa).trim();
+    pattern.stats.dfa_states = dfa->get_states().size();
+
+    FiniteAutomaton minimal = AutomatonMinifier(*dfa, options.control).minify();
+    if (options.control && options.control->is_stopped()) {
+        fall_back(pattern, describe_fallback(options));
+        return pattern;
+    }
+
+    pattern.stats.minimal_states = minimal.get_states().size();
+
+    pattern.stats.engine = PatternEngine::Dfa;
+    pattern.dfa = CompiledDfa(minimal);
+
+    if (options.jit) {
+        pattern.jit.emplace(pattern.dfa);
+        if (pattern.jit->is_native()) {
+            pattern.stats.engine = PatternEngine::Jit;
+        } else {
+            pattern.jit.reset();
+        }
+    }
+
+    if (!pattern.jit && options.sheng && ShengDfa::fits(pattern.dfa) && ShengDfa::is_supported()) {
+        pattern.sheng.emplace(pattern.dfa);
+        pattern.stats.engine = PatternEngine::Sheng;
+    }
+    return pattern;
+}
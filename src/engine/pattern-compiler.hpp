@@ -0,0 +1,106 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <utility>
+#include "compiled-dfa.hpp"
+#include "jit-compiled-dfa.hpp"
+#include "sheng-dfa.hpp"
+#include "automaton-determinator.hpp"
+#include "lazy-derivative-matcher.hpp"
+
+enum class PatternEngine {
+    Dfa, Sheng, Jit, LazyDfa
+};
+
+struct PatternCompilationStats {
+    PatternEngine engine = PatternEngine::Dfa;
+    size_t nfa_states = 0;
+    size_t dfa_states = 0;
+    size_t minimal_states = 0;
+
+    // Why the pattern is not matched with a full DFA, empty if it is
+    std::string fallback_reason;
+
+    bool used_fallback() const { return engine == PatternEngine::LazyDfa; }
+};
+
+struct PatternCompilerOptions {
+    DeterminizationLimits limits = {1 << 16, 1 << 22, 256 << 20};
+
+    // Cache size of the lazy DFA used when the limits are hit
+    size_t lazy_cache_states = 4096;
+
+    // Stopping the compilation makes the pattern fall back to the lazy DFA too
+    PipelineControl *control = nullptr;
+
+    // Compile the DFA to native code, where that's supported
+    bool jit = false;
+
+    // Match DFAs with up to 16 states by shuffles, unless the JIT is used
+    bool sheng = true;
+};
+
+// A regex prepared for matching by the fastest engine that fits the limits
+class CompiledPattern {
+public:
+    bool accepts(std::string_view input) {
+        if (lazy_matcher) {
+            return lazy_matcher->accepts(input);
+        }
+        return std::as_const(*this).accepts(input);
+    }
+
+    // Every engine but LazyDfa keeps no state while matching, so a pattern
+    // compiled to one of them may be shared between threads
+    bool accepts(std::string_view input) const {
+        assert(!lazy_matcher);
+        if (jit) {
+            return jit->accepts(input);
+        }
+        if (sheng) {
+            return sheng->accepts(input);
+        }
+        return dfa.accepts(input);
+    }
+
+    PatternEngine get_engine() const { return stats.engine; }
+
+    const PatternCompilationStats &get_stats() const { return stats; }
+
+    // Only meaningful when the engine isn't LazyDfa
+    const CompiledDfa &get_dfa() const { return dfa; }
+
+private:
+    friend class PatternCompiler;
+
+    PatternCompilationStats stats;
+    CompiledDfa dfa;
+    std::optional<JitCompiledDfa> jit;
+    std::optional<ShengDfa> sheng;
+    std::optional<LazyDerivativeMatcher> lazy_matcher;
+};
+
+// Compiles a regex: position automaton, determinization within the limits,
+// minimization and a dense table, which small DFAs run by shuffles. When
+// determinization hits a limit or the compilation is stopped, the pattern
+// falls back to the lazy derivative DFA with a bounded cache, and the
+// fallback is reported in the stats.
+
+class PatternCompiler {
+public:
+    PatternCompiler(const Regex &regex, const PatternCompilerOptions &options = {}) :
+            regex(regex), options(options) {}
+
+    CompiledPattern compile();
+
+    // Why a DFA built under the options wasn't finished: the compilation was
+    // stopped by the control, or else it exceeded the limits
+    static std::string describe_fallback(const PatternCompilerOptions &options);
+
+    const Regex &regex;
+    PatternCompilerOptions options;
+
+private:
+    void fall_back(CompiledPattern &pattern, std::string reason);
+};
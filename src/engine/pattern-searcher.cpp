@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include "pattern-searcher.hpp"
+#include "glushkov-automaton-builder.hpp"
+#include "automaton-reverser.hpp"
+
+namespace {
+
+// Runs a lazy matcher with the interface of the tables: its zero state is
+// the dead one, and an unanchored matcher starts over after it, just like
+// the UnanchoredDfa does
+class LazyTable {
+public:
+    LazyTable(LazyDerivativeMatcher &matcher, bool restart) : matcher(matcher), restart(restart) {}
+
+    size_t get_start_state() const { return matcher.get_start_state(); }
+
+    size_t step(size_t state, unsigned char byte) {
+        state = matcher.step(state, static_cast<char>(byte));
+        return restart && state == matcher.get_zero_state() ? matcher.get_start_state() : state;
+    }
+
+    bool is_final(size_t state) const { return matcher.is_final_state(state); }
+
+    bool is_dead(size_t state) const { return state == matcher.get_zero_state(); }
+
+private:
+    LazyDerivativeMatcher &matcher;
+    bool restart;
+};
+
+class BackwardTable {
+public:
+    explicit BackwardTable(const CompiledDfa &dfa) : dfa(dfa) {}
+
+    uint32_t get_start_state() const { return dfa.get_start_state(); }
+
+    uint32_t step(uint32_t state, unsigned char byte) const { return dfa.step(state, byte); }
+
+    bool is_final(uint32_t state) const { return dfa.is_final(state); }
+
+    bool is_dead(uint32_t state) const { return state == CompiledDfa::dead_state; }
+
+private:
+    const CompiledDfa &dfa;
+};
+
+}
+
+PatternSearcher::PatternSearcher(const Regex &regex, bool use_prefilter, const PatternCompilerOptions &options) {
+    literals = RegexLiteralAnalyzer(regex).analyze();
+
+    FiniteAutomaton nfa = GlushkovAutomatonBuilder(regex).build();
+    std::optional<CompiledDfa> reversed = CompiledDfa::try_minimal(AutomatonReverser(nfa).reverse(),
+                                                                   options.limits, options.control);
+    std::optional<UnanchoredDfa> forward;
+    if (reversed) {
+        forward = UnanchoredDfa::try_build(std::move(nfa), options.limits, options.control);
+    }
+
+    if (reversed && forward) {
+        backward = std::move(*reversed);
+        unanchored = std::move(*forward);
+    } else {
+        lazy_forward.emplace(UnanchoredDfa::unanchored_regex(regex), options.lazy_cache_states);
+        lazy_backward.emplace(regex.reversed(), options.lazy_cache_states);
+        fallback_reason = PatternCompiler::describe_fallback(options);
+    }
+
+    if (!use_prefilter || literals.is_empty_language) {
+        strategy = PatternSearchStrategy::Unanchored;
+    } else if (!literals.prefix.empty()) {
+        strategy = PatternSearchStrategy::Prefix;
+    } else if (!literals.suffix.empty()) {
+        strategy = PatternSearchStrategy::Suffix;
+    } else if (!literals.required.empty()) {
+        strategy = PatternSearchStrategy::Inner;
+    }
+}
+
+size_t PatternSearcher::find_literal(std::string_view text, size_t from, std::string_view literal) {
+    if (from > text.size() || literal.size() > text.size() - from) {
+        return std::string_view::npos;
+    }
+
+    const char *begin = text.data() + from;
+    size_t size = text.size() - from;
+
+    const void *found;
+    if (literal.size() == 1) {
+        found = std::memchr(begin, literal[0], size);
+    } else {
+        found = memmem(begin, size, literal.data(), literal.size());
+    }
+
+    return found ? static_cast<const char *>(found) - text.data() : std::string_view::npos;
+}
+
+template<typename Backward>
+size_t PatternSearcher::find_longest_begin(Backward &backward, std::string_view text, size_t end) {
+    auto state = backward.get_start_state();
+    size_t begin = backward.is_final(state) ? end : std::string_view::npos;
+
+    for (size_t i = end; i > 0; i--) {
+        state = backward.step(state, static_cast<unsigned char>(text[i - 1]));
+        if (backward.is_dead(state)) {
+            break;
+        }
+        if (backward.is_final(state)) {
+            begin = i - 1;
+        }
+    }
+
+    return begin;
+}
+
+template<typename Forward>
+size_t PatternSearcher::find_first_end(Forward &forward, std::string_view text) const {
+    // The empty word matches right away
+    if (forward.is_final(forward.get_start_state())) {
+        return 0;
+    }
+
+    size_t occurrence = std::string_view::npos;
+    size_t i = skip_to_candidate(text, 0, occurrence);
+    if (i == std::string_view::npos) {
+        return std::string_view::npos;
+    }
+
+    auto state = forward.get_start_state();
+    while (i < text.size()) {
+        state = forward.step(state, static_cast<unsigned char>(text[i]));
+        i++;
+        if (forward.is_final(state)) {
+            return i;
+        }
+
+        if (strategy != PatternSearchStrategy::Unanchored && state == forward.get_start_state()) {
+            i = skip_to_candidate(text, i, occurrence);
+            if (i == std::string_view::npos) {
+                break;
+            }
+        }
+    }
+
+    return std::string_view::npos;
+}
+
+size_t PatternSearcher::skip_to_candidate(std::string_view text, size_t position, size_t &occurrence) const {
+    std::string_view literal;
+    switch (strategy) {
+        case PatternSearchStrategy::Prefix:
+            literal = literals.prefix;
+            break;
+        case PatternSearchStrategy::Suffix:
+            literal = literals.suffix;
+            break;
+        case PatternSearchStrategy::Inner:
+            literal = literals.required;
+            break;
+        case PatternSearchStrategy::Unanchored:
+            return position;
+    }
+
+    // A match which starts at position or later contains a later occurrence
+    if (occurrence == std::string_view::npos || occurrence < position) {
+        occurrence = find_literal(text, position, literal);
+        if (occurrence == std::string_view::npos) {
+            return std::string_view::npos;
+        }
+    }
+
+    // Every match starts at an occurrence of the prefix
+    if (strategy == PatternSearchStrategy::Prefix) {
+        return occurrence;
+    }
+
+    // No match ends before the occurrence does, and a match is never longer than max_length
+    size_t literal_end = occurrence + literal.size();
+    if (literals.max_length != SIZE_MAX && literal_end > literals.max_length) {
+        return std::max(position, literal_end - literals.max_length);
+    }
+    return position;
+}
+
+template<typename Forward, typename Backward>
+std::optional<PatternMatch> PatternSearcher::find_with(Forward &forward, Backward &backward,
+                                                       std::string_view text) const {
+    size_t end = find_first_end(forward, text);
+    if (end == std::string_view::npos) {
+        return std::nullopt;
+    }
+    return PatternMatch{find_longest_begin(backward, text, end), end};
+}
+
+std::optional<PatternMatch> PatternSearcher::find(std::string_view text) {
+    if (lazy_forward) {
+        LazyTable forward(*lazy_forward, true);
+        LazyTable reversed(*lazy_backward, false);
+        return find_with(forward, reversed, text);
+    }
+    return std::as_const(*this).find(text);
+}
+
+std::optional<PatternMatch> PatternSearcher::find(std::string_view text) const {
+    assert(!lazy_forward);
+    BackwardTable reversed(backward);
+    return find_with(unanchored, reversed, text);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include "compiled-dfa.hpp"
+#include "unanchored-dfa.hpp"
+#include "lazy-derivative-matcher.hpp"
+#include "pattern-compiler.hpp"
+#include "regex-literal-analyzer.hpp"
+
+struct PatternMatch {
+    size_t begin;
+    size_t end;
+
+    bool operator==(const PatternMatch &other) const = default;
+};
+
+enum class PatternSearchStrategy {
+    // Scan every byte with the unanchored DFA
+    Unanchored,
+    // Skip to the next occurrence of the required prefix
+    Prefix,
+    // Skip to the end of the next occurrence of the required suffix, minus
+    // the longest word length when it's finite
+    Suffix,
+    // The same with a required literal anywhere in the words
+    Inner
+};
+
+// Finds occurrences of a regex in text. The reported match is the one which
+// ends first, and of those the longest one, which is what a single forward
+// pass over the text can find. Whenever the unanchored DFA is in its start
+// state no match is in progress, so the pass jumps over the text which can't
+// hold the start of one, found from the next occurrence of a literal every
+// match contains with memchr/memmem, and stops when there's none. Every byte
+// is stepped at most once and the literal searches don't overlap, then a
+// reversed pass goes back from the end found, so the search stays linear
+// however many occurrences of the literal there are.
+//
+// The DFAs are only built within PatternCompilerOptions::limits. Past them
+// the searcher falls back to lazy derivative DFAs with a bounded cache, of
+// Σ*·regex forward and of the reversed regex backward, and like a pattern on
+// the LazyDfa engine it keeps state while searching then.
+
+class PatternSearcher {
+public:
+    explicit PatternSearcher(const Regex &regex, bool use_prefilter = true,
+                             const PatternCompilerOptions &options = {});
+
+    std::optional<PatternMatch> find(std::string_view text);
+
+    // The DFAs keep no state while searching, so a searcher which didn't
+    // fall back may be shared between threads
+    std::optional<PatternMatch> find(std::string_view text) const;
+
+    bool contains(std::string_view text) { return find(text).has_value(); }
+
+    bool contains(std::string_view text) const { return find(text).has_value(); }
+
+    // Why the search runs on the lazy DFAs, empty when it doesn't
+    const std::string &get_fallback_reason() const { return fallback_reason; }
+
+    PatternSearchStrategy get_strategy() const { return strategy; }
+
+    const RegexLiterals &get_literals() const { return literals; }
+
+    // Position of the literal in the text at or after from, npos if there's none
+    static size_t find_literal(std::string_view text, size_t from, std::string_view literal);
+
+private:
+    // Start of the longest match ending at end, npos if there's none
+    template<typename Backward>
+    static size_t find_longest_begin(Backward &backward, std::string_view text, size_t end);
+
+    // End of the first match, npos if there's none
+    template<typename Forward>
+    size_t find_first_end(Forward &forward, std::string_view text) const;
+
+    template<typename Forward, typename Backward>
+    std::optional<PatternMatch> find_with(Forward &forward, Backward &backward, std::string_view text) const;
+
+    // Where the next match can start at the earliest, given that none is in
+    // progress at position, npos when the rest can't hold one. The next
+    // occurrence of the literal is kept in occurrence until it's passed.
+    size_t skip_to_candidate(std::string_view text, size_t position, size_t &occurrence) const;
+
+    RegexLiterals literals;
+    PatternSearchStrategy strategy = PatternSearchStrategy::Unanchored;
+
+    // The minimal DFA of the reversed language
+    CompiledDfa backward;
+    UnanchoredDfa unanchored;
+
+    // Only made when the DFAs are past the limits
+    std::optional<LazyDerivativeMatcher> lazy_forward;
+    std::optional<LazyDerivativeMatcher> lazy_backward;
+    std::string fallback_reason;
+};
@@ -0,0 +1 @@
+#include "pipeline-control.hpp"
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+
+// Flag shared between the thread running a pipeline and the threads which
+// may want to cancel it. Copies refer to the same flag.
+class CancellationToken {
+public:
+    CancellationToken() : flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() { flag->store(true, std::memory_order_relaxed); }
+
+    bool is_cancelled() const { return flag->load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag;
+};
+
+enum class PipelineStopReason {
+    None, Cancelled, DeadlineExceeded
+};
+
+struct PipelineProgress {
+    const char *stage;
+    size_t done;
+    // Estimate of the work left in the stage, zero when the stage is over
+    size_t remaining;
+};
+
+// Lets the pipeline stages be interrupted cooperatively. The stages call
+// should_stop() periodically and bail out once it returns true, and report
+// their progress through report_progress(). A stage which was stopped and
+// returns an automaton returns a valid one of the empty language, a single
+// non-final state, so it's safe to query but wrong: check is_stopped(), or
+// use the try_ variants which return nothing instead. A stage which works in
+// place leaves a well-formed automaton of an unspecified language.
+
+class PipelineControl {
+public:
+    using ProgressCallback = std::function<void(const PipelineProgress &)>;
+
+    void set_cancellation_token(const CancellationToken &token) { cancellation_token = token; }
+
+    void set_deadline(std::chrono::steady_clock::time_point time) { deadline = time; }
+
+    void set_timeout(std::chrono::steady_clock::duration timeout) {
+        deadline = std::chrono::steady_clock::now() + timeout;
+    }
+
+    // The callback is called at most once per interval, and always when a stage is over
+    void set_progress_callback(ProgressCallback callback,
+                               std::chrono::steady_clock::duration interval = std::chrono::milliseconds(100)) {
+        progress_callback = std::move(callback);
+        progress_interval = interval;
+    }
+
+    bool should_stop() {
+        if (stop_reason != PipelineStopReason::None) {
+            return true;
+        }
+
+        if (cancellation_token && cancellation_token->is_cancelled()) {
+            stop_reason = PipelineStopReason::Cancelled;
+            return true;
+        }
+
+        // Reading the clock is not free, so it's only done every few checks
+        if (deadline && (checks++ % deadline_check_period) == 0 && std::chrono::steady_clock::now() >= *deadline) {
+            stop_reason = PipelineStopReason::DeadlineExceeded;
+            return true;
+        }
+
+        return false;
+    }
+
+    void report_progress(const char *stage, size_t done, size_t remaining) {
+        if (!progress_callback) {
+            return;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (remaining != 0 && now - last_report < progress_interval) {
+            return;
+        }
+
+        last_report = now;
+        progress_callback({stage, done, remaining});
+    }
+
+    bool is_stopped() const { return stop_reason != PipelineStopReason::None; }
+
+    PipelineStopReason get_stop_reason() const { return stop_reason; }
+
+private:
+    static constexpr size_t deadline_check_period = 64;
+
+    std::optional<CancellationToken> cancellation_token;
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+
+    ProgressCallback progress_callback;
+    std::chrono::steady_clock::duration progress_interval{};
+    std::chrono::steady_clock::time_point last_report{};
+
+    PipelineStopReason stop_reason = PipelineStopReason::None;
+    size_t checks = 0;
+};
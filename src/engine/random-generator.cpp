@@ -0,0 +1,116 @@
+#include "random-generator.hpp"
+
+Regex RandomRegexGenerator::generate() {
+    return generate(config.size, config.max_depth);
+}
+
+Regex RandomRegexGenerator::generate(size_t size, size_t depth) {
+    if (size <= 1 || depth == 0) {
+        if (random.next_bool(config.epsilon_probability)) {
+            return Regex::empty();
+        }
+        return Regex(CharRegex(random.next_char(config.alphabet)));
+    }
+
+    if (random.next_bool(config.star_probability)) {
+        return Regex(StarRegex(generate(size - 1, depth - 1)));
+    }
+
+    // Split the remaining size between the operands, giving at least one node to each
+    size_t width = 2;
+    if (config.max_width > 2) {
+        width += random.next_index(config.max_width - 1);
+    }
+    width = std::min(width, size - 1);
+
+    std::vector<size_t> operand_sizes(width, 1);
+    for (size_t i = width; i < size - 1; i++) {
+        operand_sizes[random.next_index(width)]++;
+    }
+
+    std::vector<Regex> operands;
+    for (size_t operand_size: operand_sizes) {
+        operands.push_back(generate(operand_size, depth - 1));
+    }
+
+    if (width == 1) {
+        return std::move(operands[0]);
+    }
+
+    if (random.next_bool(config.sum_probability)) {
+        return Regex(SumRegex{std::move(operands)});
+    }
+    return Regex(ConcatRegex{std::move(operands)});
+}
+
+FiniteAutomaton RandomAutomatonGenerator::generate() {
+    FiniteAutomaton automaton;
+
+    size_t state_count = config.state_count;
+    size_t letter_count = config.alphabet.size();
+
+    for (size_t i = 0; i < state_count; i++) {
+        automaton.add_state(random.next_bool(config.final_probability));
+    }
+
+    automaton.extend_alphabet(std::set<char>(config.alphabet.begin(), config.alphabet.end()));
+
+    // Slot is a (state, letter) pair, encoded as state * letter_count + letter
+    std::vector<bool> used_slots(state_count * letter_count, false);
+
+    auto add_slot_transition = [&](size_t slot, size_t target) {
+        size_t source = slot / letter_count;
+        char letter = config.alphabet[slot % letter_count];
+
+        if (automaton.find_transition(letter, source, target) == -1) {
+            automaton.add_transition(source, target, Regex(CharRegex(letter)));
+        }
+        used_slots[slot] = true;
+    };
+
+    if (config.ensure_reachable) {
+        // Every new state takes a free slot of an already reachable state,
+        // so the spanning tree never breaks determinism
+        std::vector<size_t> free_slots;
+
+        for (size_t letter = 0; letter < letter_count; letter++) {
+            free_slots.push_back(letter);
+        }
+
+        for (size_t state = 1; state < state_count; state++) {
+            size_t index = random.next_index(free_slots.size());
+            size_t slot = free_slots[index];
+            free_slots[index] = free_slots.back();
+            free_slots.pop_back();
+
+            add_slot_transition(slot, state);
+
+            for (size_t letter = 0; letter < letter_count; letter++) {
+                free_slots.push_back(state * letter_count + letter);
+            }
+        }
+    }
+
+    for (size_t slot = 0; slot < used_slots.size(); slot++) {
+        if (!used_slots[slot] && random.next_bool(config.density)) {
+            add_slot_transition(slot, random.next_index(state_count));
+        }
+    }
+
+    for (size_t slot = 0; slot < used_slots.size(); slot++) {
+        if (used_slots[slot] && !random.next_bool(config.determinism)) {
+            add_slot_transition(slot, random.next_index(state_count));
+        }
+    }
+
+    for (size_t state = 0; state < state_count; state++) {
+        if (random.next_bool(config.epsilon_probability)) {
+            size_t target = random.next_index(state_count);
+            if (target != state) {
+                automaton.add_transition(state, target, Regex::empty());
+            }
+        }
+    }
+
+    return automaton;
+}
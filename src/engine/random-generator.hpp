@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include "finite-automaton.hpp"
+
+// Seeded generators of random regexes and automata for load and scaling tests.
+// The same seed and config always produce the same output: the generators only
+// rely on std::mt19937_64, whose sequence is fixed by the standard, and avoid
+// std::*_distribution, whose output differs between standard libraries.
+
+class RandomSource {
+public:
+    explicit RandomSource(uint64_t seed) : engine(seed) {}
+
+    // Uniform integer in [0, bound)
+    size_t next_index(size_t bound) {
+        assert(bound > 0);
+        return static_cast<size_t>(engine() % bound);
+    }
+
+    // Uniform real in [0, 1)
+    double next_real() {
+        return static_cast<double>(engine() >> 11) * 0x1.0p-53;
+    }
+
+    bool next_bool(double probability) {
+        return next_real() < probability;
+    }
+
+    char next_char(const std::string &alphabet) {
+        return alphabet[next_index(alphabet.size())];
+    }
+
+private:
+    std::mt19937_64 engine;
+};
+
+struct RandomRegexConfig {
+    std::string alphabet = "ab";
+
+    // Approximate number of nodes in the generated tree
+    size_t size = 16;
+
+    // Maximal nesting depth of the tree, leaves are at depth zero
+    size_t max_depth = 6;
+
+    // Maximal number of operands of a single sum or concatenation
+    size_t max_width = 3;
+
+    double star_probability = 0.2;
+    double sum_probability = 0.4;
+    double epsilon_probability = 0.05;
+};
+
+class RandomRegexGenerator {
+public:
+    RandomRegexGenerator(const RandomRegexConfig &config, uint64_t seed) : config(config), random(seed) {
+        assert(!config.alphabet.empty());
+    }
+
+    Regex generate();
+
+    RandomRegexConfig config;
+
+private:
+    Regex generate(size_t size, size_t depth);
+
+    RandomSource random;
+};
+
+struct RandomAutomatonConfig {
+    std::string alphabet = "ab";
+
+    size_t state_count = 16;
+
+    // Probability that a (state, letter) pair gets a transition at all
+    double density = 0.8;
+
+    // Probability that a (state, letter) pair stops at a single target.
+    // With determinism = 1 and epsilon_probability = 0 the result is a DFA.
+    double determinism = 1.0;
+
+    double final_probability = 0.2;
+
+    // Probability of an epsilon-transition leaving each state
+    double epsilon_probability = 0.0;
+
+    // Connect all states to the start state with a random spanning tree
+    bool ensure_reachable = true;
+};
+
+class RandomAutomatonGenerator {
+public:
+    RandomAutomatonGenerator(const RandomAutomatonConfig &config, uint64_t seed) : config(config), random(seed) {
+        assert(!config.alphabet.empty());
+        assert(config.state_count > 0);
+    }
+
+    FiniteAutomaton generate();
+
+    RandomAutomatonConfig config;
+
+private:
+    RandomSource random;
+};
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include "regex-derivative.hpp"
+
+bool RegexDerivative::is_nullable(const Regex &regex) {
+    switch (regex.type) {
+        case RegexType::Char:
+            return std::get<CharRegex>(regex.value).ch == '\0';
+        case RegexType::Concat:
+            for (auto &operand: std::get<ConcatRegex>(regex.value).operands) {
+                if (!is_nullable(operand)) {
+                    return false;
+                }
+            }
+            return true;
+        case RegexType::Sum:
+            for (auto &operand: std::get<SumRegex>(regex.value).operands) {
+                if (is_nullable(operand)) {
+                    return true;
+                }
+            }
+            return false;
+        case RegexType::Star:
+            return true;
+    }
+    return false;
+}
+
+Regex RegexDerivative::normalize(const Regex &regex) {
+    switch (regex.type) {
+        case RegexType::Char:
+            return regex;
+        case RegexType::Concat: {
+            std::vector<Regex> operands;
+            for (auto &operand: std::get<ConcatRegex>(regex.value).operands) {
+                operands.push_back(normalize(operand));
+            }
+            return make_concat(std::move(operands));
+        }
+        case RegexType::Sum: {
+            std::vector<Regex> operands;
+            for (auto &operand: std::get<SumRegex>(regex.value).operands) {
+                operands.push_back(normalize(operand));
+            }
+            return make_sum(std::move(operands));
+        }
+        case RegexType::Star:
+            return make_star(normalize(std::get<StarRegex>(regex.value).get_operand()));
+    }
+    return regex;
+}
+
+Regex RegexDerivative::derive(const Regex &regex, char c) {
+    if (c == '\0') {
+        return Regex::zero();
+    }
+
+    switch (regex.type) {
+        case RegexType::Char:
+            return std::get<CharRegex>(regex.value).ch == c ? Regex::empty() : Regex::zero();
+        case RegexType::Concat: {
+            // d(r1 r2 ... rn) = d(r1) r2 ... rn + d(r2) r3 ... rn + ..., while the prefix is nullable
+            auto &operands = std::get<ConcatRegex>(regex.value).operands;
+            std::vector<Regex> terms;
+
+            for (size_t i = 0; i < operands.size(); i++) {
+                std::vector<Regex> term = {derive(operands[i], c)};
+                term.insert(term.end(), operands.begin() + static_cast<long>(i) + 1, operands.end());
+                terms.push_back(make_concat(std::move(term)));
+
+                if (!is_nullable(operands[i])) {
+                    break;
+                }
+            }
+
+            return make_sum(std::move(terms));
+        }
+        case RegexType::Sum: {
+            std::vector<Regex> terms;
+            for (auto &operand: std::get<SumRegex>(regex.value).operands) {
+                terms.push_back(derive(operand, c));
+            }
+            return make_sum(std::move(terms));
+        }
+        case RegexType::Star: {
+            std::vector<Regex> term = {derive(std::get<StarRegex>(regex.value).get_operand(), c), regex};
+            return make_concat(std::move(term));
+        }
+    }
+    return Regex::zero();
+}
+
+static void add_partial_derivatives(const Regex &regex, char c, const std::vector<Regex> &tail,
+                                    std::vector<Regex> &terms) {
+    auto add_term = [&](Regex &&term) {
+        std::vector<Regex> operands = {std::move(term)};
+        operands.insert(operands.end(), tail.begin(), tail.end());
+        Regex result = RegexDerivative::make_concat(std::move(operands));
+        if (!result.is_zero()) {
+            terms.push_back(std::move(result));
+        }
+    };
+
+    switch (regex.type) {
+        case RegexType::Char:
+            if (std::get<CharRegex>(regex.value).ch == c) {
+                add_term(Regex::empty());
+            }
+            break;
+        case RegexType::Concat: {
+            auto &operands = std::get<ConcatRegex>(regex.value).operands;
+
+            for (size_t i = 0; i < operands.size(); i++) {
+                std::vector<Regex> next_tail(operands.begin() + static_cast<long>(i) + 1, operands.end());
+                next_tail.insert(next_tail.end(), tail.begin(), tail.end());
+                add_partial_derivatives(operands[i], c, next_tail, terms);
+
+                if (!RegexDerivative::is_nullable(operands[i])) {
+                    break;
+                }
+            }
+            break;
+        }
+        case RegexType::Sum:
+            for (auto &operand: std::get<SumRegex>(regex.value).operands) {
+                add_partial_derivatives(operand, c, tail, terms);
+            }
+            break;
+        case RegexType::Star: {
+            std::vector<Regex> next_tail = {regex};
+            next_tail.insert(next_tail.end(), tail.begin(), tail.end());
+            add_partial_derivatives(std::get<StarRegex>(regex.value).get_operand(), c, next_tail, terms);
+            break;
+        }
+    }
+}
+
+std::vector<Regex> RegexDerivative::derive_partial(const Regex &regex, char c) {
+    std::vector<Regex> terms;
+
+    if (c != '\0') {
+        add_partial_derivatives(regex, c, {}, terms);
+    }
+
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+    return terms;
+}
+
+Regex RegexDerivative::make_sum(std::vector<Regex> &&operands) {
+    std::vector<Regex> flat;
+
+    for (auto &operand: operands) {
+        if (operand.type == RegexType::Sum) {
+            for (auto &inner: std::get<SumRegex>(operand.value).operands) {
+                flat.push_back(std::move(inner));
+            }
+        } else {
+            flat.push_back(std::move(operand));
+        }
+    }
+
+    std::sort(flat.begin(), flat.end());
+    flat.erase(std::unique(flat.begin(), flat.end()), flat.end());
+
+    if (flat.size() == 1) {
+        return std::move(flat[0]);
+    }
+    return Regex(SumRegex{std::move(flat)});
+}
+
+Regex RegexDerivative::make_concat(std::vector<Regex> &&operands) {
+    std::vector<Regex> flat;
+
+    for (auto &operand: operands) {
+        if (operand.is_zero()) {
+            return Regex::zero();
+        }
+        if (operand.is_empty()) {
+            continue;
+        }
+        if (operand.type == RegexType::Concat) {
+            for (auto &inner: std::get<ConcatRegex>(operand.value).operands) {
+                flat.push_back(std::move(inner));
+            }
+        } else {
+            flat.push_back(std::move(operand));
+        }
+    }
+
+    if (flat.empty()) {
+        return Regex::empty();
+    }
+    if (flat.size() == 1) {
+        return std::move(flat[0]);
+    }
+    return Regex(ConcatRegex{std::move(flat)});
+}
+
+Regex RegexDerivative::make_star(Regex &&operand) {
+    if (operand.is_zero() || operand.is_empty()) {
+        return Regex::empty();
+    }
+    if (operand.type == RegexType::Star) {
+        return std::move(operand);
+    }
+    return Regex(StarRegex(std::move(operand)));
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "regex.hpp"
+
+// Brzozowski derivatives of regexes. All the results are kept in a normal form:
+// sums are flattened, sorted and deduplicated, concatenations are flattened,
+// ε and ∅ are folded away. Under this normalization every regex has only
+// finitely many distinct derivatives, so they can be used as DFA states.
+
+struct RegexDerivative {
+    static bool is_nullable(const Regex &regex);
+
+    static Regex normalize(const Regex &regex);
+
+    // Derivative of a normalized regex by a character
+    static Regex derive(const Regex &regex, char c);
+
+    // Antimirov partial derivative of a normalized regex by a character:
+    // the derivative split into a sorted set of terms, whose sum is derive(regex, c)
+    static std::vector<Regex> derive_partial(const Regex &regex, char c);
+
+    // Constructors which keep the result normalized, given normalized operands
+    static Regex make_sum(std::vector<Regex> &&operands);
+
+    static Regex make_concat(std::vector<Regex> &&operands);
+
+    static Regex make_star(Regex &&operand);
+};
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <vector>
+#include "regex-literal-analyzer.hpp"
+
+static size_t add_lengths(size_t left, size_t right) {
+    if (left == SIZE_MAX || right == SIZE_MAX) {
+        return SIZE_MAX;
+    }
+    return left + right;
+}
+
+static std::string longest_common_substring(const std::string &left, const std::string &right) {
+    // lengths[j] is the length of the common suffix of the current prefix of left and right[0..j)
+    std::vector<size_t> lengths(right.size() + 1, 0);
+    size_t best_length = 0;
+    size_t best_end = 0;
+
+    for (size_t i = 1; i <= left.size(); i++) {
+        for (size_t j = right.size(); j > 0; j--) {
+            lengths[j] = left[i - 1] == right[j - 1] ? lengths[j - 1] + 1 : 0;
+            if (lengths[j] > best_length) {
+                best_length = lengths[j];
+                best_end = i;
+            }
+        }
+    }
+
+    return left.substr(best_end - best_length, best_length);
+}
+
+void RegexLiteralAnalyzer::choose_required(RegexLiterals &literals, const std::string &candidate) {
+    if (candidate.size() > literals.required.size()) {
+        literals.required = candidate;
+    }
+}
+
+RegexLiterals RegexLiteralAnalyzer::concat(const RegexLiterals &left, const RegexLiterals &right) {
+    if (left.is_empty_language || right.is_empty_language) {
+        RegexLiterals result;
+        result.is_empty_language = true;
+        return result;
+    }
+
+    RegexLiterals result;
+    result.prefix = left.exact ? *left.exact + right.prefix : left.prefix;
+    result.suffix = right.exact ? left.suffix + *right.exact : right.suffix;
+    if (left.exact && right.exact) {
+        result.exact = *left.exact + *right.exact;
+    }
+    result.max_length = add_lengths(left.max_length, right.max_length);
+
+    // The suffix of the left part is followed by the prefix of the right one in every word
+    choose_required(result, left.required);
+    choose_required(result, right.required);
+    choose_required(result, left.suffix + right.prefix);
+    choose_required(result, result.prefix);
+    choose_required(result, result.suffix);
+    return result;
+}
+
+RegexLiterals RegexLiteralAnalyzer::sum(const RegexLiterals &left, const RegexLiterals &right) {
+    if (left.is_empty_language) {
+        return right;
+    }
+    if (right.is_empty_language) {
+        return left;
+    }
+
+    RegexLiterals result;
+
+    auto prefix_end = std::mismatch(left.prefix.begin(), left.prefix.end(), right.prefix.begin(), right.prefix.end());
+    result.prefix.assign(left.prefix.begin(), prefix_end.first);
+
+    auto suffix_end = std::mismatch(left.suffix.rbegin(), left.suffix.rend(), right.suffix.rbegin(), right.suffix.rend());
+    result.suffix.assign(suffix_end.first.base(), left.suffix.end());
+
+    if (left.exact && right.exact && *left.exact == *right.exact) {
+        result.exact = left.exact;
+    }
+    result.max_length = std::max(left.max_length, right.max_length);
+
+    // A literal both operands contain is required by the sum
+    for (auto *left_literal: {&left.required, &left.prefix, &left.suffix}) {
+        for (auto *right_literal: {&right.required, &right.prefix, &right.suffix}) {
+            choose_required(result, longest_common_substring(*left_literal, *right_literal));
+        }
+    }
+    return result;
+}
+
+RegexLiterals RegexLiteralAnalyzer::visit(const Regex &node) {
+    switch (node.type) {
+        case RegexType::Char: {
+            RegexLiterals result;
+            char c = std::get<CharRegex>(node.value).ch;
+            if (c != '\0') {
+                result.prefix = result.suffix = result.required = std::string(1, c);
+                result.max_length = 1;
+            }
+            result.exact = result.prefix;
+            return result;
+        }
+        case RegexType::Concat: {
+            RegexLiterals result = visit(Regex::empty());
+            for (auto &operand: std::get<ConcatRegex>(node.value).operands) {
+                result = concat(result, visit(operand));
+            }
+            return result;
+        }
+        case RegexType::Sum: {
+            RegexLiterals result;
+            result.is_empty_language = true;
+            for (auto &operand: std::get<SumRegex>(node.value).operands) {
+                result = sum(result, visit(operand));
+            }
+            return result;
+        }
+        case RegexType::Star: {
+            RegexLiterals operand = visit(std::get<StarRegex>(node.value).get_operand());
+            RegexLiterals result;
+            result.exact = std::string();
+            if (!operand.is_empty_language && operand.max_length > 0) {
+                result.exact.reset();
+                result.max_length = SIZE_MAX;
+            }
+            return result;
+        }
+    }
+    return {};
+}
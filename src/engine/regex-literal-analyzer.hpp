@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include "regex.hpp"
+
+// Literals which every word of a regex language contains
+struct RegexLiterals {
+    // Every word starts with the prefix and ends with the suffix
+    std::string prefix;
+    std::string suffix;
+
+    // The longest literal known to occur in every word, at least as long as
+    // the prefix and the suffix
+    std::string required;
+
+    // The only word of the language, if it has exactly one
+    std::optional<std::string> exact;
+
+    // Length of the longest word, SIZE_MAX if the language is infinite
+    size_t max_length = 0;
+
+    // Set when the language is empty, the other fields are meaningless then
+    bool is_empty_language = false;
+};
+
+// Collects RegexLiterals bottom-up over the regex tree. The analysis is exact
+// for concatenations of letters and conservative elsewhere: a sum keeps only
+// what all of its operands share, and a star requires nothing, since it
+// matches the empty word.
+
+class RegexLiteralAnalyzer {
+public:
+    RegexLiteralAnalyzer(const Regex &regex) : regex(regex) {}
+
+    RegexLiterals analyze() const { return visit(regex); }
+
+    const Regex &regex;
+
+private:
+    static RegexLiterals visit(const Regex &node);
+
+    static RegexLiterals concat(const RegexLiterals &left, const RegexLiterals &right);
+
+    static RegexLiterals sum(const RegexLiterals &left, const RegexLiterals &right);
+
+    static void choose_required(RegexLiterals &literals, const std::string &candidate);
+};
@@ -0,0 +1,122 @@
+#include "regex-parser.hpp"
+
+std::optional<Regex> RegexParser::parse() {
+    position = 0;
+    error.clear();
+
+    std::optional<Regex> result = parse_sum();
+    if (result && !at_end()) {
+        fail("unexpected ')'");
+        return std::nullopt;
+    }
+    return result;
+}
+
+void RegexParser::skip_spaces() {
+    while (!at_end() && text[position] == ' ') {
+        position++;
+    }
+}
+
+void RegexParser::fail(const std::string &message) {
+    if (error.empty()) {
+        error = message + " at position " + std::to_string(position);
+    }
+}
+
+std::optional<Regex> RegexParser::parse_sum() {
+    SumRegex sum;
+
+    while (true) {
+        std::optional<Regex> operand = parse_concat();
+        if (!operand) {
+            return std::nullopt;
+        }
+        sum.operands.push_back(std::move(*operand));
+
+        skip_spaces();
+        if (at_end() || text[position] != '+') {
+            break;
+        }
+        position++;
+    }
+
+    if (sum.operands.size() == 1) {
+        return std::move(sum.operands[0]);
+    }
+    return Regex(std::move(sum));
+}
+
+std::optional<Regex> RegexParser::parse_concat() {
+    ConcatRegex concat;
+
+    skip_spaces();
+    while (!at_sum_end()) {
+        std::optional<Regex> operand = parse_item();
+        if (!operand) {
+            return std::nullopt;
+        }
+        concat.operands.push_back(std::move(*operand));
+        skip_spaces();
+    }
+
+    if (concat.operands.empty()) {
+        fail("expected an expression");
+        return std::nullopt;
+    }
+    if (concat.operands.size() == 1) {
+        return std::move(concat.operands[0]);
+    }
+    return Regex(std::move(concat));
+}
+
+std::optional<Regex> RegexParser::parse_item() {
+    std::optional<Regex> result = parse_atom();
+
+    while (result && !at_end() && text[position] == '*') {
+        position++;
+        result = Regex(StarRegex(std::move(*result)));
+    }
+
+    return result;
+}
+
+std::optional<Regex> RegexParser::parse_atom() {
+    if (at_epsilon()) {
+        position += epsilon.size();
+        return Regex::empty();
+    }
+
+    char c = text[position];
+
+    if (c == '*') {
+        fail("nothing to repeat");
+        return std::nullopt;
+    }
+
+    if (c != '(') {
+        position++;
+        return Regex(CharRegex(c));
+    }
+
+    position++;
+    skip_spaces();
+
+    if (!at_end() && text[position] == ')') {
+        position++;
+        return Regex::zero();
+    }
+
+    std::optional<Regex> result = parse_sum();
+    if (!result) {
+        return std::nullopt;
+    }
+
+    if (at_end() || text[position] != ')') {
+        fail("expected ')'");
+        return std::nullopt;
+    }
+    position++;
+
+    return result;
+}
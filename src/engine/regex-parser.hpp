@@ -0,0 +1,47 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include "regex.hpp"
+
+// Parses regexes in the format they are printed in: letters are concatenated
+// by writing them one after another, a sum is "(x + y)", a star is "(x)*",
+// "ε" is the empty word and "()" is the empty language. Spaces are ignored,
+// and a star may follow any letter or parenthesized expression.
+
+class RegexParser {
+public:
+    RegexParser(std::string_view text) : text(text) {}
+
+    // Returns nothing on a syntax error, see get_error()
+    std::optional<Regex> parse();
+
+    const std::string &get_error() const { return error; }
+
+    std::string_view text;
+
+private:
+    std::optional<Regex> parse_sum();
+
+    std::optional<Regex> parse_concat();
+
+    std::optional<Regex> parse_item();
+
+    std::optional<Regex> parse_atom();
+
+    void skip_spaces();
+
+    bool at_end() const { return position >= text.size(); }
+
+    bool at_epsilon() const { return text.substr(position, epsilon.size()) == epsilon; }
+
+    bool at_sum_end() const { return at_end() || text[position] == ')' || text[position] == '+'; }
+
+    void fail(const std::string &message);
+
+    static constexpr std::string_view epsilon = "ε";
+
+    size_t position = 0;
+    std::string error;
+};
@@ -120,7 +120,7 @@ Regex::Regex(const Regex &copy) {
     *this = copy;
 }
 
-Regex::Regex(Regex &&move) {
+Regex::Regex(Regex &&move) noexcept {
     *this = std::move(move);
 }
 
@@ -219,6 +219,30 @@ void Regex::fill_alphabet(std::set<char> &alphabet) const {
     }
 }
 
+Regex Regex::reversed() const {
+    switch (type) {
+        case RegexType::Concat: {
+            ConcatRegex concat{};
+            auto &operands = std::get<ConcatRegex>(value).operands;
+            for (auto it = operands.rbegin(); it != operands.rend(); ++it) {
+                concat.operands.push_back(it->reversed());
+            }
+            return {std::move(concat)};
+        }
+        case RegexType::Sum: {
+            SumRegex sum{};
+            for (auto &operand: std::get<SumRegex>(value).operands) {
+                sum.operands.push_back(operand.reversed());
+            }
+            return {std::move(sum)};
+        }
+        case RegexType::Star:
+            return {StarRegex(std::get<StarRegex>(value).get_operand().reversed())};
+        default:
+            return *this;
+    }
+}
+
 std::string Regex::print() const {
     std::stringstream ss;
     ss << (*this);
@@ -252,6 +276,78 @@ bool Regex::operator==(const Regex &other) const {
     }
 }
 
+static int compare_regex(const Regex &left, const Regex &right);
+
+static int compare_operands(const std::vector<Regex> &left, const std::vector<Regex> &right) {
+    if (left.size() != right.size()) {
+        return left.size() < right.size() ? -1 : 1;
+    }
+    for (size_t i = 0; i < left.size(); i++) {
+        int result = compare_regex(left[i], right[i]);
+        if (result != 0) {
+            return result;
+        }
+    }
+    return 0;
+}
+
+static int compare_regex(const Regex &left, const Regex &right) {
+    if (left.type != right.type) {
+        return left.type < right.type ? -1 : 1;
+    }
+
+    switch (left.type) {
+        case RegexType::Char: {
+            char left_ch = std::get<CharRegex>(left.value).ch;
+            char right_ch = std::get<CharRegex>(right.value).ch;
+            return left_ch == right_ch ? 0 : (left_ch < right_ch ? -1 : 1);
+        }
+        case RegexType::Concat:
+            return compare_operands(std::get<ConcatRegex>(left.value).operands,
+                                    std::get<ConcatRegex>(right.value).operands);
+        case RegexType::Sum:
+            return compare_operands(std::get<SumRegex>(left.value).operands,
+                                    std::get<SumRegex>(right.value).operands);
+        case RegexType::Star:
+            return compare_regex(std::get<StarRegex>(left.value).get_operand(),
+                                 std::get<StarRegex>(right.value).get_operand());
+    }
+    return 0;
+}
+
+bool Regex::operator<(const Regex &other) const {
+    return compare_regex(*this, other) < 0;
+}
+
+size_t Regex::hash() const {
+    size_t result = static_cast<size_t>(type) + 1;
+
+    auto combine = [&](size_t value) {
+        result ^= value + 0x9e3779b97f4a7c15ULL + (result << 6) + (result >> 2);
+    };
+
+    switch (type) {
+        case RegexType::Char:
+            combine(static_cast<unsigned char>(std::get<CharRegex>(value).ch));
+            break;
+        case RegexType::Concat:
+            for (auto &operand: std::get<ConcatRegex>(value).operands) {
+                combine(operand.hash());
+            }
+            break;
+        case RegexType::Sum:
+            for (auto &operand: std::get<SumRegex>(value).operands) {
+                combine(operand.hash());
+            }
+            break;
+        case RegexType::Star:
+            combine(std::get<StarRegex>(value).get_operand().hash());
+            break;
+    }
+
+    return result;
+}
+
 char CharRegex::get_char(const Regex &regex) {
     return std::get<CharRegex>(regex.value).ch;
 }
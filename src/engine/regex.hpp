@@ -74,7 +74,7 @@ struct Regex {
 
     Regex(const Regex &copy);
 
-    Regex(Regex &&move);
+    Regex(Regex &&move) noexcept;
 
     Regex(const CharRegex &value) : type(RegexType::Char), value(value) {}
 
@@ -102,8 +102,16 @@ struct Regex {
 
     bool operator==(const Regex &other) const;
 
+    // Structural total order, used to keep regexes in sorted containers
+    bool operator<(const Regex &other) const;
+
+    size_t hash() const;
+
     void fill_alphabet(std::set<char>& alphabet) const;
 
+    // The regex of the mirror images of its words
+    Regex reversed() const;
+
     // To use in LLDB
     std::string print() const;
 
@@ -114,6 +122,10 @@ struct Regex {
     bool is_empty() const;
 };
 
+struct RegexHash {
+    size_t operator()(const Regex &regex) const { return regex.hash(); }
+};
+
 Regex operator ""_r(const char *string, size_t size);
 
 std::ostream &operator<<(std::ostream &os, Regex const &regex);
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "sheng-dfa.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SHENG_DFA_X86 1
+#include <immintrin.h>
+#endif
+
+bool ShengDfa::is_supported() {
+#ifdef SHENG_DFA_X86
+    return __builtin_cpu_supports("ssse3");
+#else
+    return false;
+#endif
+}
+
+ShengDfa::ShengDfa(const CompiledDfa &dfa) : dfa(dfa) {
+    if (!fits(dfa)) {
+        return;
+    }
+
+    // Lanes of the states which don't exist stay in the dead state
+    for (size_t byte = 0; byte < 256; byte++) {
+        for (uint32_t state = 0; state < dfa.get_state_count(); state++) {
+            masks[byte][state] = static_cast<uint8_t>(dfa.step(state, static_cast<unsigned char>(byte)));
+        }
+    }
+
+    for (uint32_t state = 0; state < dfa.get_state_count(); state++) {
+        if (dfa.is_final(state)) {
+            finals |= static_cast<uint16_t>(1u << state);
+        }
+    }
+
+    vectorized = is_supported();
+}
+
+bool ShengDfa::accepts(std::string_view input) const {
+    if (!vectorized) {
+        return dfa.accepts(input);
+    }
+    return (finals >> run_vectorized(input)) & 1;
+}
+
+#ifdef SHENG_DFA_X86
+
+__attribute__((target("ssse3")))
+uint8_t ShengDfa::run_vectorized(std::string_view input) const {
+    // The state is in the lowest lane, pshufb by it picks the next state from the mask
+    __m128i state = _mm_cvtsi32_si128(static_cast<int>(dfa.get_start_state()));
+
+    auto bytes = reinterpret_cast<const unsigned char *>(input.data());
+    size_t size = input.size();
+
+    // The dead state is only checked between the blocks, to keep the loop free of branches
+    constexpr size_t block = 64;
+
+    for (size_t i = 0; i < size; i += block) {
+        size_t end = std::min(size, i + block);
+
+        for (size_t j = i; j < end; j++) {
+            __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i *>(masks[bytes[j]].data()));
+            state = _mm_shuffle_epi8(mask, state);
+        }
+
+        if ((_mm_cvtsi128_si32(state) & 0xFF) == CompiledDfa::dead_state) {
+            break;
+        }
+    }
+
+    return static_cast<uint8_t>(_mm_cvtsi128_si32(state) & 0xFF);
+}
+
+#else
+
+uint8_t ShengDfa::run_vectorized(std::string_view input) const {
+    return static_cast<uint8_t>(dfa.run(dfa.get_start_state(), input));
+}
+
+#endif
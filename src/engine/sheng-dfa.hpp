@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include "compiled-dfa.hpp"
+
+// Matcher for DFAs with at most 16 states, the dead one included. For every
+// byte there's a 16-byte vector holding the next state of each state, so one
+// step is a single pshufb of that vector by the current state: the transition
+// function never has to be looked up through the current state, and the only
+// dependency between the steps is a register.
+//
+// The shuffle needs SSSE3, which is checked at runtime. Without it, or on
+// other architectures, the CompiledDfa table is run instead.
+
+class ShengDfa {
+public:
+    static constexpr size_t max_states = 16;
+
+    static bool fits(const CompiledDfa &dfa) { return dfa.get_state_count() <= max_states; }
+
+    // Whether the CPU can run the shuffle loop
+    static bool is_supported();
+
+    explicit ShengDfa(const CompiledDfa &dfa);
+
+    bool accepts(std::string_view input) const;
+
+    // Whether accepts() runs the shuffle loop rather than the table
+    bool is_vectorized() const { return vectorized; }
+
+    const CompiledDfa &get_dfa() const { return dfa; }
+
+private:
+    uint8_t run_vectorized(std::string_view input) const;
+
+    CompiledDfa dfa;
+    bool vectorized = false;
+
+    // masks[byte][state] is the state after reading the byte
+    alignas(16) std::array<std::array<uint8_t, max_states>, 256> masks{};
+    uint16_t finals = 0;
+};
@@ -0,0 +1,406 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Regexes compiled to DFAs entirely at compile time:
+//
+//     static_assert(static_match<"a((b + c))*d">("abcd"));
+//     bool valid = StaticRegex<"((0 + 1))*">::match(input);
+//
+// The pattern is in the format RegexParser reads. It is turned into a
+// position (Glushkov) automaton, determinized and minimized by constexpr
+// code, and only the resulting table ends up in the binary, so there's
+// nothing to do at startup. A syntax error in the pattern fails the build.
+
+template<size_t N>
+struct FixedString {
+    char data[N]{};
+
+    constexpr FixedString(const char (&string)[N]) {
+        std::copy_n(string, N, data);
+    }
+
+    constexpr std::string_view view() const { return {data, N - 1}; }
+};
+
+// The minimized DFA in the same layout as CompiledDfa: state 0 is the dead
+// state, bytes outside of the pattern alphabet are in class 0
+template<size_t States, size_t Classes>
+struct StaticDfa {
+    static_assert(States <= UINT16_MAX + 1, "Too many DFA states for a static regex");
+
+    static constexpr size_t state_count = States;
+    static constexpr size_t class_count = Classes;
+
+    std::array<uint8_t, 256> byte_classes{};
+    std::array<uint16_t, States * Classes> transitions{};
+    std::array<bool, States> finals{};
+    uint16_t start_state = 0;
+
+    constexpr bool match(std::string_view input) const {
+        uint16_t state = start_state;
+
+        for (char c: input) {
+            state = transitions[state * Classes + byte_classes[static_cast<unsigned char>(c)]];
+            if (state == 0) {
+                return false;
+            }
+        }
+
+        return finals[state];
+    }
+};
+
+// The constexpr pipeline. Its containers are std::vector, which may only live
+// during constant evaluation, so the result is measured first and then copied
+// into a StaticDfa of the right size.
+class StaticRegexCompiler {
+public:
+    struct Automaton {
+        bool valid = false;
+        size_t state_count = 1;
+        size_t class_count = 1;
+        std::array<uint8_t, 256> byte_classes{};
+        std::vector<uint16_t> transitions;
+        std::vector<bool> finals;
+        uint16_t start_state = 0;
+    };
+
+    struct Sizes {
+        bool valid;
+        size_t states;
+        size_t classes;
+    };
+
+    static constexpr Sizes measure(std::string_view pattern) {
+        Automaton automaton = build(pattern);
+        return {automaton.valid, automaton.state_count, automaton.class_count};
+    }
+
+    template<size_t States, size_t Classes>
+    static constexpr StaticDfa<States, Classes> compile(std::string_view pattern) {
+        Automaton automaton = build(pattern);
+        StaticDfa<States, Classes> result;
+
+        if (!automaton.valid) {
+            return result;
+        }
+
+        result.byte_classes = automaton.byte_classes;
+        std::copy(automaton.transitions.begin(), automaton.transitions.end(), result.transitions.begin());
+        std::copy(automaton.finals.begin(), automaton.finals.end(), result.finals.begin());
+        result.start_state = automaton.start_state;
+        return result;
+    }
+
+    static constexpr Automaton build(std::string_view pattern) {
+        Automaton result;
+        Parser parser(pattern);
+
+        Subexpression regex = parser.parse();
+        if (!parser.valid) {
+            return result;
+        }
+
+        parser.follow[0] = regex.first;
+        std::vector<bool> position_finals(parser.letters.size(), false);
+        for (size_t position: regex.last) {
+            position_finals[position] = true;
+        }
+        position_finals[0] = regex.is_nullable;
+
+        // Letters of the pattern become the byte classes 1, 2, ...
+        std::vector<char> alphabet(parser.letters.begin() + 1, parser.letters.end());
+        std::sort(alphabet.begin(), alphabet.end());
+        alphabet.erase(std::unique(alphabet.begin(), alphabet.end()), alphabet.end());
+
+        size_t class_count = alphabet.size() + 1;
+        for (size_t i = 0; i < alphabet.size(); i++) {
+            result.byte_classes[static_cast<unsigned char>(alphabet[i])] = static_cast<uint8_t>(i + 1);
+        }
+
+        // Subset construction, superpositions are sorted lists of positions
+        std::vector<std::vector<size_t>> superpositions = {{0}};
+        std::vector<size_t> dfa_transitions;
+        const size_t dead = SIZE_MAX;
+
+        for (size_t i = 0; i < superpositions.size(); i++) {
+            for (char letter: alphabet) {
+                std::vector<size_t> targets;
+                for (size_t position: superpositions[i]) {
+                    for (size_t target: parser.follow[position]) {
+                        if (parser.letters[target] == letter) {
+                            targets.push_back(target);
+                        }
+                    }
+                }
+                std::sort(targets.begin(), targets.end());
+                targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+
+                if (targets.empty()) {
+                    dfa_transitions.push_back(dead);
+                    continue;
+                }
+
+                auto it = std::find(superpositions.begin(), superpositions.end(), targets);
+                dfa_transitions.push_back(it - superpositions.begin());
+                if (it == superpositions.end()) {
+                    superpositions.push_back(std::move(targets));
+                }
+            }
+        }
+
+        // Moore refinement with the dead state as the last one
+        size_t dfa_states = superpositions.size() + 1;
+        size_t letter_count = alphabet.size();
+        std::vector<size_t> classes(dfa_states, 0);
+
+        for (size_t i = 0; i + 1 < dfa_states; i++) {
+            for (size_t position: superpositions[i]) {
+                if (position_finals[position]) {
+                    classes[i] = 1;
+                }
+            }
+        }
+
+        auto target_of = [&](size_t state, size_t letter) {
+            if (state == dfa_states - 1 || dfa_transitions[state * letter_count + letter] == dead) {
+                return dfa_states - 1;
+            }
+            return dfa_transitions[state * letter_count + letter];
+        };
+
+        size_t class_total = 0;
+        while (true) {
+            // A state goes to the class of the first state with the same signature
+            std::vector<size_t> next_classes(dfa_states);
+            std::vector<size_t> representatives;
+
+            for (size_t state = 0; state < dfa_states; state++) {
+                size_t found = representatives.size();
+                for (size_t j = 0; j < representatives.size(); j++) {
+                    size_t other = representatives[j];
+                    bool same = classes[state] == classes[other];
+                    for (size_t letter = 0; same && letter < letter_count; letter++) {
+                        same = classes[target_of(state, letter)] == classes[target_of(other, letter)];
+                    }
+                    if (same) {
+                        found = j;
+                        break;
+                    }
+                }
+                if (found == representatives.size()) {
+                    representatives.push_back(state);
+                }
+                next_classes[state] = found;
+            }
+
+            classes = std::move(next_classes);
+            if (representatives.size() == class_total) {
+                break;
+            }
+            class_total = representatives.size();
+        }
+
+        // The dead class becomes state 0, the others follow in order
+        size_t dead_class = classes[dfa_states - 1];
+        std::vector<uint16_t> numbers(class_total, 0);
+        std::vector<size_t> representatives(class_total, 0);
+        uint16_t next_number = 1;
+
+        for (size_t state = 0; state < dfa_states; state++) {
+            size_t cls = classes[state];
+            if (cls != dead_class && numbers[cls] == 0) {
+                numbers[cls] = next_number++;
+                representatives[cls] = state;
+            }
+        }
+
+        result.state_count = next_number;
+        result.class_count = class_count;
+        result.transitions.assign(result.state_count * class_count, 0);
+        result.finals.assign(result.state_count, false);
+        result.start_state = numbers[classes[0]];
+
+        for (size_t cls = 0; cls < class_total; cls++) {
+            if (cls == dead_class) {
+                continue;
+            }
+
+            size_t state = representatives[cls];
+            uint16_t number = numbers[cls];
+
+            for (size_t position: superpositions[state]) {
+                if (position_finals[position]) {
+                    result.finals[number] = true;
+                }
+            }
+            for (size_t letter = 0; letter < letter_count; letter++) {
+                result.transitions[number * class_count + letter + 1] = numbers[classes[target_of(state, letter)]];
+            }
+        }
+
+        result.valid = true;
+        return result;
+    }
+
+private:
+    struct Subexpression {
+        bool is_nullable = false;
+        std::vector<size_t> first;
+        std::vector<size_t> last;
+    };
+
+    // Recursive descent over the pattern collecting the first, last and
+    // follow sets of the positions, position 0 is the initial state
+    struct Parser {
+        constexpr explicit Parser(std::string_view text) : text(text), letters(1, '\0'), follow(1) {}
+
+        constexpr Subexpression parse() {
+            Subexpression result = parse_sum();
+            if (position != text.size()) {
+                valid = false;
+            }
+            return result;
+        }
+
+        constexpr void skip_spaces() {
+            while (position < text.size() && text[position] == ' ') {
+                position++;
+            }
+        }
+
+        constexpr bool at_sum_end() const {
+            return position >= text.size() || text[position] == ')' || text[position] == '+';
+        }
+
+        constexpr void add_follow(const std::vector<size_t> &from, const std::vector<size_t> &to) {
+            for (size_t source: from) {
+                follow[source].insert(follow[source].end(), to.begin(), to.end());
+            }
+        }
+
+        constexpr Subexpression parse_sum() {
+            Subexpression result = parse_concat();
+
+            skip_spaces();
+            while (valid && position < text.size() && text[position] == '+') {
+                position++;
+                Subexpression operand = parse_concat();
+                result.is_nullable = result.is_nullable || operand.is_nullable;
+                result.first.insert(result.first.end(), operand.first.begin(), operand.first.end());
+                result.last.insert(result.last.end(), operand.last.begin(), operand.last.end());
+                skip_spaces();
+            }
+
+            return result;
+        }
+
+        constexpr Subexpression parse_concat() {
+            Subexpression result{true, {}, {}};
+            bool empty = true;
+
+            skip_spaces();
+            while (valid && !at_sum_end()) {
+                Subexpression operand = parse_item();
+                add_follow(result.last, operand.first);
+
+                if (result.is_nullable) {
+                    result.first.insert(result.first.end(), operand.first.begin(), operand.first.end());
+                }
+                if (operand.is_nullable) {
+                    result.last.insert(result.last.end(), operand.last.begin(), operand.last.end());
+                } else {
+                    result.last = std::move(operand.last);
+                }
+                result.is_nullable = result.is_nullable && operand.is_nullable;
+
+                empty = false;
+                skip_spaces();
+            }
+
+            if (empty) {
+                valid = false;
+            }
+            return result;
+        }
+
+        constexpr Subexpression parse_item() {
+            Subexpression result = parse_atom();
+
+            while (valid && position < text.size() && text[position] == '*') {
+                position++;
+                add_follow(result.last, result.first);
+                result.is_nullable = true;
+            }
+
+            return result;
+        }
+
+        constexpr Subexpression parse_atom() {
+            if (text.substr(position, epsilon.size()) == epsilon) {
+                position += epsilon.size();
+                return {true, {}, {}};
+            }
+
+            char c = text[position++];
+
+            if (c == '*') {
+                valid = false;
+                return {};
+            }
+
+            if (c != '(') {
+                letters.push_back(c);
+                follow.emplace_back();
+                return {false, {letters.size() - 1}, {letters.size() - 1}};
+            }
+
+            skip_spaces();
+            if (position < text.size() && text[position] == ')') {
+                // The empty language
+                position++;
+                return {};
+            }
+
+            Subexpression result = parse_sum();
+            if (position >= text.size() || text[position] != ')') {
+                valid = false;
+                return {};
+            }
+            position++;
+
+            return result;
+        }
+
+        static constexpr std::string_view epsilon = "ε";
+
+        std::string_view text;
+        size_t position = 0;
+        bool valid = true;
+
+        std::vector<char> letters;
+        std::vector<std::vector<size_t>> follow;
+    };
+};
+
+template<FixedString Pattern>
+struct StaticRegex {
+    static constexpr StaticRegexCompiler::Sizes sizes = StaticRegexCompiler::measure(Pattern.view());
+    static_assert(sizes.valid, "Invalid static regex pattern");
+
+    static constexpr auto dfa = StaticRegexCompiler::compile<sizes.states, sizes.classes>(Pattern.view());
+
+    static constexpr bool match(std::string_view input) {
+        return dfa.match(input);
+    }
+};
+
+template<FixedString Pattern>
+constexpr bool static_match(std::string_view input) {
+    return StaticRegex<Pattern>::match(input);
+}
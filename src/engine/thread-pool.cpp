@@ -0,0 +1,91 @@
+#include <algorithm>
+#include "thread-pool.hpp"
+
+ThreadPool::ThreadPool(size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = 1;
+    }
+
+    for (size_t i = 1; i < thread_count; i++) {
+        workers.emplace_back([this, i] { worker_loop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    job_started.notify_all();
+
+    for (auto &worker: workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallel_for(size_t count, const std::function<void(size_t, size_t)> &function, size_t grain) {
+    if (count == 0) {
+        return;
+    }
+
+    if (workers.empty() || count <= grain) {
+        for (size_t i = 0; i < count; i++) {
+            function(i, 0);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard lock(mutex);
+        job_function = &function;
+        job_count = count;
+        job_grain = grain == 0 ? 1 : grain;
+        next_index = 0;
+        running_workers = workers.size();
+        job_generation++;
+    }
+    job_started.notify_all();
+
+    run_job(0);
+
+    std::unique_lock lock(mutex);
+    job_finished.wait(lock, [this] { return running_workers == 0; });
+    job_function = nullptr;
+}
+
+void ThreadPool::worker_loop(size_t thread_index) {
+    size_t seen_generation = 0;
+
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            job_started.wait(lock, [&] { return stopping || job_generation != seen_generation; });
+            if (stopping) {
+                return;
+            }
+            seen_generation = job_generation;
+        }
+
+        run_job(thread_index);
+
+        {
+            std::lock_guard lock(mutex);
+            running_workers--;
+        }
+        job_finished.notify_one();
+    }
+}
+
+void ThreadPool::run_job(size_t thread_index) {
+    while (true) {
+        size_t begin = next_index.fetch_add(job_grain);
+        if (begin >= job_count) {
+            return;
+        }
+
+        size_t end = std::min(begin + job_grain, job_count);
+        for (size_t i = begin; i < end; i++) {
+            (*job_function)(i, thread_index);
+        }
+    }
+}
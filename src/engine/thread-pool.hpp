@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads running parallel loops. The thread calling
+// parallel_for takes part in the loop as thread 0, so a pool of one thread
+// runs everything inline.
+
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t thread_count = std::thread::hardware_concurrency());
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &copy) = delete;
+
+    ThreadPool &operator=(const ThreadPool &copy) = delete;
+
+    // Calls function(index, thread_index) for every index in [0, count) and
+    // waits for all the calls to finish. Indices are handed out in blocks of grain.
+    void parallel_for(size_t count, const std::function<void(size_t, size_t)> &function, size_t grain = 1);
+
+    size_t get_thread_count() const { return workers.size() + 1; }
+
+private:
+    void worker_loop(size_t thread_index);
+
+    void run_job(size_t thread_index);
+
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable job_started;
+    std::condition_variable job_finished;
+
+    const std::function<void(size_t, size_t)> *job_function = nullptr;
+    size_t job_count = 0;
+    size_t job_grain = 1;
+    std::atomic<size_t> next_index = 0;
+
+    size_t job_generation = 0;
+    size_t running_workers = 0;
+    bool stopping = false;
+};
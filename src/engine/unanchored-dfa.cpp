@@ -0,0 +1,30 @@
+#include "unanchored-dfa.hpp"
+
+std::optional<UnanchoredDfa> UnanchoredDfa::try_build(FiniteAutomaton automaton, const DeterminizationLimits &limits,
+                                                      PipelineControl *control) {
+    // A match may start anywhere, so the start state loops on every letter
+    for (char letter: automaton.alphabet) {
+        automaton.add_transition(automaton.get_start_state_index(), automaton.get_start_state_index(),
+                                 Regex(CharRegex(letter)));
+    }
+
+    std::optional<CompiledDfa> dfa = CompiledDfa::try_minimal(automaton, limits, control);
+    if (!dfa) {
+        return std::nullopt;
+    }
+    return UnanchoredDfa(std::move(*dfa));
+}
+
+Regex UnanchoredDfa::unanchored_regex(const Regex &regex) {
+    std::set<char> letters;
+    regex.fill_alphabet(letters);
+    if (letters.empty()) {
+        return regex;
+    }
+
+    Regex any = Regex::zero();
+    for (char letter: letters) {
+        any += Regex(CharRegex(letter));
+    }
+    return *any * regex;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "compiled-dfa.hpp"
+#include "automaton-determinator.hpp"
+
+// The minimal DFA of all the words which end with a word of the language, for
+// finding matches anywhere in a text: it's in a final state right after the
+// end of every match. The start state of the automaton loops over the
+// alphabet of the automaton only, so a byte outside of it leads to the dead
+// state. No match contains such a byte, so step() starts over from the start
+// state after it, and the dead state is only ever reached when the language
+// is empty. Searching for every prefix at once can blow the DFA up
+// exponentially, so it's only built within DeterminizationLimits.
+
+class UnanchoredDfa {
+public:
+    UnanchoredDfa() = default;
+
+    // Returns nothing when the DFA outgrows the limits or the pipeline is stopped
+    static std::optional<UnanchoredDfa> try_build(FiniteAutomaton automaton, const DeterminizationLimits &limits,
+                                                  PipelineControl *control = nullptr);
+
+    // Σ*·regex over the alphabet of the regex, the language of the DFA of the
+    // regex, for matching it lazily instead
+    static Regex unanchored_regex(const Regex &regex);
+
+    uint32_t step(uint32_t state, unsigned char byte) const {
+        state = dfa.step(state, byte);
+        return state == CompiledDfa::dead_state ? dfa.get_start_state() : state;
+    }
+
+    bool is_final(uint32_t state) const { return dfa.is_final(state); }
+
+    uint32_t get_start_state() const { return dfa.get_start_state(); }
+
+    const CompiledDfa &get_dfa() const { return dfa; }
+
+private:
+    explicit UnanchoredDfa(CompiledDfa dfa) : dfa(std::move(dfa)) {}
+
+    CompiledDfa dfa;
+};
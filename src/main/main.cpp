@@ -1,46 +1,319 @@
+#include <charconv>
+#include <chrono>
+#include <cstring>
 #include <iostream>
-#include "../engine/regex.hpp"
-#include "../engine/finite-automaton.hpp"
-#include "../engine/automaton-simplifier.hpp"
-#include "../engine/epsilon-remover.hpp"
-#include "../engine/automaton-optimizer.hpp"
-#include "../engine/automaton-determinator.hpp"
-#include "../engine/automaton-inverter.hpp"
-#include "../engine/automaton-collapser.hpp"
-#include "../engine/automaton-to-regex-converter.hpp"
-#include "../engine/automaton-minifier.hpp"
-#include "../engine/automaton-graphviz-printer.hpp"
-
-Regex invert_regex(const Regex& regex, const std::set<char>& alphabet = {}) {
-    FiniteAutomaton automaton(regex);
-    automaton.extend_alphabet(alphabet);
-    AutomatonSimplifier(automaton).simplify();
-
-    EpsilonRemover(automaton).simplify();
-    AutomatonOptimizer(automaton).optimize();
-    AutomatonCompleter(automaton).complete();
-    automaton = AutomatonDeterminator(automaton).determine();
-    automaton = AutomatonMinifier(automaton).minify();
-    AutomatonInverter(automaton).invert();
-
-    std::cout << AutomatonGraphvizPrinter(automaton) << "\n";
-
-    AutomatonCollapser(automaton).collapse();
-
-    return AutomatonToRegexConverter(automaton).convert();
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../engine/regex-parser.hpp"
+#include "../engine/line-scanner.hpp"
+#include "../engine/thread-pool.hpp"
+
+// Prints the lines of files which match a regex, like grep.
+// Usage: formal_languages [options] REGEX [FILE...]
+//        formal_languages [options] -e REGEX [-e REGEX]... [FILE...]
+// The regexes are in the format they're printed in, like "a((b + c))*", a
+// line matches if it contains a word of any of them. Without files, or for
+// "-", the standard input is read as a stream.
+
+struct ScanOptions {
+    // The whole line has to be a word of a regex instead of containing one
+    bool whole_lines = false;
+    bool count_only = false;
+    bool line_numbers = false;
+    bool byte_offsets = false;
+    bool stats = false;
+    size_t threads = std::thread::hardware_concurrency();
+};
+
+// Files are split between the threads at line breaks, in chunks of about this size
+static constexpr size_t chunk_size = 1 << 20;
+
+// Size of the reads from a stream
+static constexpr size_t read_size = 1 << 16;
+
+// A read-only mapping of a whole file
+class MappedFile {
+public:
+    explicit MappedFile(const std::string &path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1) {
+            return;
+        }
+
+        struct stat info{};
+        if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+            valid = true;
+            size = static_cast<size_t>(info.st_size);
+        }
+
+        // Empty files can't be mapped
+        if (valid && size > 0) {
+            void *address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address == MAP_FAILED) {
+                valid = false;
+            } else {
+                data = static_cast<const char *>(address);
+                madvise(address, size, MADV_SEQUENTIAL);
+            }
+        }
+
+        close(fd);
+    }
+
+    ~MappedFile() {
+        if (data) {
+            munmap(const_cast<char *>(data), size);
+        }
+    }
+
+    MappedFile(const MappedFile &copy) = delete;
+
+    MappedFile &operator=(const MappedFile &copy) = delete;
+
+    bool is_valid() const { return valid; }
+
+    std::string_view view() const { return {data, size}; }
+
+private:
+    const char *data = nullptr;
+    size_t size = 0;
+    bool valid = false;
+};
+
+// Cuts the text into chunks of about chunk_size which end at line breaks
+static std::vector<std::string_view> split_chunks(std::string_view text) {
+    std::vector<std::string_view> chunks;
+    size_t begin = 0;
+
+    while (begin < text.size()) {
+        size_t end = begin + chunk_size;
+        if (end >= text.size()) {
+            end = text.size();
+        } else {
+            auto newline = static_cast<const char *>(memchr(text.data() + end, '\n', text.size() - end));
+            end = newline ? newline - text.data() + 1 : text.size();
+        }
+        chunks.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+
+    return chunks;
 }
 
-int main() {
+static int usage() {
+    std::cerr << "Usage: formal_languages [options] REGEX [FILE...]\n"
+                 "       formal_languages [options] -e REGEX [-e REGEX]... [FILE...]\n"
+                 "Options:\n"
+                 "  -x, --line-regexp   match whole lines only\n"
+                 "  -c, --count         print the number of matching lines\n"
+                 "  -n, --line-number   print line numbers\n"
+                 "  -b, --byte-offset   print byte offsets of the lines\n"
+                 "  -j, --threads N     number of threads\n"
+                 "  --stats             print the throughput to stderr\n";
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    ScanOptions options;
+    std::vector<std::string> patterns;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+
+        if ((argument == "-e" || argument == "--regexp") && i + 1 < argc) {
+            patterns.emplace_back(argv[++i]);
+        } else if (argument == "-x" || argument == "--line-regexp") {
+            options.whole_lines = true;
+        } else if (argument == "-c" || argument == "--count") {
+            options.count_only = true;
+        } else if (argument == "-n" || argument == "--line-number") {
+            options.line_numbers = true;
+        } else if (argument == "-b" || argument == "--byte-offset") {
+            options.byte_offsets = true;
+        } else if ((argument == "-j" || argument == "--threads") && i + 1 < argc) {
+            std::string_view value = argv[++i];
+            auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), options.threads);
+            if (error != std::errc() || end != value.data() + value.size() || options.threads == 0) {
+                std::cerr << "Invalid number of threads: " << value << "\n";
+                return usage();
+            }
+        } else if (argument == "--stats") {
+            options.stats = true;
+        } else if (argument == "-h" || argument == "--help") {
+            return usage();
+        } else if (argument.size() > 1 && argument[0] == '-') {
+            std::cerr << "Unknown option: " << argument << "\n";
+            return usage();
+        } else if (patterns.empty()) {
+            patterns.push_back(argument);
+        } else {
+            paths.push_back(argument);
+        }
+    }
+
+    if (patterns.empty()) {
+        return usage();
+    }
+    if (paths.empty()) {
+        paths.emplace_back("-");
+    }
+
+    // Several regexes match as their sum
+    Regex regex = Regex::zero();
+    for (auto &pattern: patterns) {
+        RegexParser parser(pattern);
+        std::optional<Regex> parsed = parser.parse();
+        if (!parsed) {
+            std::cerr << "Invalid regex \"" << pattern << "\": " << parser.get_error() << "\n";
+            return 2;
+        }
+        regex = patterns.size() == 1 ? *parsed : regex + *parsed;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ThreadPool pool(options.threads);
+
+    // Whole lines are matched by the fastest engine the DFA allows
+    PatternCompilerOptions compiler_options;
+    compiler_options.jit = true;
+    LineScanner scanner(regex, options.whole_lines ? LineMatchMode::Whole : LineMatchMode::Contains, true,
+                        compiler_options);
+
+    const char *engines[] = {"dfa", "sheng", "jit", "lazy-dfa"};
+    std::string matcher_name = std::string(options.whole_lines ? "whole lines" : "contains") + ", " +
+                               engines[static_cast<int>(scanner.get_engine())];
+    if (scanner.get_engine() == PatternEngine::LazyDfa) {
+        matcher_name += " (" + scanner.get_fallback_reason() + ")";
+    } else {
+        matcher_name += ", " + std::to_string(scanner.get_dfa().get_state_count()) + " states";
+    }
+    if (!scanner.get_literal().empty()) {
+        matcher_name += ", prefilter \"" + scanner.get_literal() + "\"";
+    }
+
+    size_t total_bytes = 0;
+    size_t total_lines = 0;
+    size_t total_matches = 0;
+    bool failed = false;
+
+    for (auto &path: paths) {
+        std::string prefix = paths.size() > 1 ? path + ":" : "";
+        size_t file_matches = 0;
+
+        auto print_line = [&](std::string_view line, size_t number, size_t offset) {
+            file_matches++;
+            if (options.count_only) {
+                return;
+            }
+            std::cout << prefix;
+            if (options.line_numbers) {
+                std::cout << number + 1 << ":";
+            }
+            if (options.byte_offsets) {
+                std::cout << offset << ":";
+            }
+            std::cout << line << "\n";
+        };
+
+        if (path == "-") {
+            // Only the unfinished line is kept between the reads
+            LineScanStream stream(scanner);
+            std::vector<LineSpan> found;
+            std::string buffer;
+            size_t buffer_offset = 0;
+            std::vector<char> block(read_size);
+
+            while (true) {
+                ssize_t size = read(STDIN_FILENO, block.data(), block.size());
+                if (size < 0) {
+                    std::cerr << "Cannot read the standard input\n";
+                    failed = true;
+                    break;
+                }
+
+                found.clear();
+                if (size == 0) {
+                    stream.finish(found);
+                } else {
+                    buffer.append(block.data(), size);
+                    stream.feed({block.data(), static_cast<size_t>(size)}, found);
+                }
+
+                for (auto &line: found) {
+                    print_line(std::string_view(buffer).substr(line.begin - buffer_offset, line.end - line.begin),
+                               line.number, line.begin);
+                }
+
+                buffer.erase(0, stream.get_line_begin() - buffer_offset);
+                buffer_offset = stream.get_line_begin();
+                total_bytes += size;
+
+                if (size == 0) {
+                    break;
+                }
+            }
+
+            total_lines += stream.get_line_count();
+        } else {
+            MappedFile file(path);
+            if (!file.is_valid()) {
+                std::cerr << "Cannot read " << path << "\n";
+                failed = true;
+                continue;
+            }
+
+            std::string_view text = file.view();
+            std::vector<std::string_view> chunks = split_chunks(text);
+
+            // Every chunk ends with a line break, so its lines are numbered from 0
+            std::vector<std::vector<LineSpan>> found(chunks.size());
+            std::vector<size_t> line_counts(chunks.size(), 0);
+
+            pool.parallel_for(chunks.size(), [&](size_t index, size_t) {
+                LineScanStream stream(scanner);
+                stream.feed(chunks[index], found[index]);
+                stream.finish(found[index]);
+                line_counts[index] = stream.get_line_count();
+            });
+
+            size_t line_number = 0;
+            for (size_t index = 0; index < chunks.size(); index++) {
+                size_t offset = chunks[index].data() - text.data();
+                for (auto &line: found[index]) {
+                    print_line(chunks[index].substr(line.begin, line.end - line.begin), line_number + line.number,
+                               offset + line.begin);
+                }
+                line_number += line_counts[index];
+            }
 
-//    Regex regex = *("ab"_r + "ba"_r) * (Regex() + "a"_r + "ba"_r);
-//    Regex regex = *"ab"_r * *"b"_r + *(("a"_r + "b"_r) * ("a"_r + "b"_r));
-//    Regex regex = "a"_r * *((*"ba"_r * *"a"_r * *"ab"_r) + "a"_r);
+            total_bytes += text.size();
+            total_lines += line_number;
+        }
 
-    Regex regex = "a"_r * *(*("ba"_r) * "a"_r * *("ab"_r) + "a"_r);
+        if (options.count_only) {
+            std::cout << prefix << file_matches << "\n";
+        }
+        total_matches += file_matches;
+    }
 
-    std::cout << regex << "\n";
+    std::cout.flush();
 
-    std::cout << invert_regex(regex, {'a', 'b'}) << "\n";
+    if (options.stats) {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cerr << "matcher: " << matcher_name << "\n"
+                  << "threads: " << pool.get_thread_count() << "\n"
+                  << "bytes: " << total_bytes << "\n"
+                  << "lines: " << total_lines << "\n"
+                  << "matching lines: " << total_matches << "\n"
+                  << "time: " << seconds * 1000 << " ms\n"
+                  << "throughput: " << static_cast<double>(total_bytes) / (1 << 20) / seconds << " MB/s\n";
+    }
 
-    return 0;
+    if (failed) {
+        return 2;
+    }
+    return total_matches > 0 ? 0 : 1;
 }
@@ -9,6 +9,31 @@
 #include "../engine/automaton-minifier.hpp"
 #include "../engine/automaton-inverter.hpp"
 #include "../engine/automaton-collapser.hpp"
+#include "../engine/random-generator.hpp"
+#include "../engine/automaton-product.hpp"
+#include "../engine/automaton-equivalence-checker.hpp"
+#include "../engine/automaton-inclusion-checker.hpp"
+#include "../engine/derivative-automaton-builder.hpp"
+#include "../engine/lazy-derivative-matcher.hpp"
+#include "../engine/glushkov-automaton-builder.hpp"
+#include "../engine/antimirov-automaton-builder.hpp"
+#include "../engine/parallel-automaton-determinator.hpp"
+#include "../engine/parallel-automaton-minifier.hpp"
+#include "../engine/pattern-compiler.hpp"
+#include "../engine/automaton-reverser.hpp"
+#include "../engine/brzozowski-minifier.hpp"
+#include "../engine/regex-parser.hpp"
+#include "../engine/automaton-cpp-printer.hpp"
+#include "../engine/static-regex.hpp"
+#include "../engine/jit-compiled-dfa.hpp"
+#include "../engine/pattern-searcher.hpp"
+#include "../engine/sheng-dfa.hpp"
+#include "../engine/interleaved-dfa-matcher.hpp"
+#include "../engine/parallel-dfa-matcher.hpp"
+#include "../engine/line-scanner.hpp"
+#include "../engine/batch-matcher.hpp"
+#include "generated_switch_matcher.hpp"
+#include "generated_table_matcher.hpp"
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
@@ -312,4 +337,1272 @@ TEST(test_automaton_minify, test_automaton_minify_3) {
 
     EXPECT_EQ(regex_1, regex_2);
     EXPECT_EQ(regex_2, regex_3);
-}
\ No newline at end of file
+}
+std::string automaton_to_string(const FiniteAutomaton& automaton) {
+    std::stringstream ss;
+    ss << AutomatonGraphvizPrinter(automaton);
+    return ss.str();
+}
+
+std::vector<std::string> random_words(const std::string& alphabet, size_t count, size_t max_length, uint64_t seed) {
+    RandomSource random(seed);
+    std::vector<std::string> words = {""};
+
+    while (words.size() < count) {
+        std::string word;
+        size_t length = random.next_index(max_length + 1);
+        for (size_t i = 0; i < length; i++) {
+            word.push_back(random.next_char(alphabet));
+        }
+        words.push_back(word);
+    }
+
+    return words;
+}
+
+TEST(test_random_generator, test_random_regex_reproducible) {
+    RandomRegexConfig config;
+    config.size = 40;
+
+    Regex regex_1 = RandomRegexGenerator(config, 42).generate();
+    Regex regex_2 = RandomRegexGenerator(config, 42).generate();
+    Regex regex_3 = RandomRegexGenerator(config, 43).generate();
+
+    EXPECT_EQ(regex_1, regex_2);
+    EXPECT_NE(regex_to_string(regex_1), regex_to_string(regex_3));
+}
+
+TEST(test_random_generator, test_random_automaton_shape) {
+    RandomAutomatonConfig config;
+    config.alphabet = "abc";
+    config.state_count = 50;
+
+    FiniteAutomaton automaton = RandomAutomatonGenerator(config, 7).generate();
+
+    EXPECT_EQ(automaton.get_states().size(), 50);
+    EXPECT_EQ(automaton.alphabet, std::set<char>({'a', 'b', 'c'}));
+    EXPECT_TRUE(automaton.is_deterministic());
+
+    AutomatonOptimizer(automaton).remove_unreachable_states();
+    EXPECT_EQ(automaton.get_states().size(), 50) << "All states should be reachable";
+
+    config.determinism = 0.5;
+    FiniteAutomaton nfa = RandomAutomatonGenerator(config, 7).generate();
+    EXPECT_FALSE(nfa.is_deterministic());
+    EXPECT_EQ(automaton_to_string(nfa), automaton_to_string(RandomAutomatonGenerator(config, 7).generate()));
+}
+
+TEST(test_random_generator, test_random_regex_pipeline) {
+    // Every stage of the pipeline should preserve the language of a random regex
+    RandomRegexConfig config;
+    config.size = 24;
+
+    std::vector<std::string> words = random_words(config.alphabet, 64, 8, 1);
+
+    for (uint64_t seed = 0; seed < 10; seed++) {
+        FiniteAutomaton automaton(RandomRegexGenerator(config, seed).generate());
+        std::vector<bool> expected;
+
+        for (AutomatonConfigIterator config_iterator(automaton); config_iterator; config_iterator.next()) {
+            for (size_t i = 0; i < words.size(); i++) {
+                if (expected.size() < words.size()) {
+                    expected.push_back(automaton.accepts(words[i]));
+                } else {
+                    EXPECT_EQ(automaton.accepts(words[i]), expected[i])
+                                        << "Stage " << config_iterator.current_config << " changed the language on \""
+                                        << words[i] << "\", seed " << seed;
+                }
+            }
+        }
+    }
+}
+
+FiniteAutomaton to_nfa(const Regex& regex) {
+    FiniteAutomaton automaton(regex);
+    AutomatonSimplifier(automaton).simplify();
+    EpsilonRemover(automaton).simplify();
+    AutomatonOptimizer(automaton).optimize();
+    return automaton;
+}
+
+bool apply_operation(AutomatonProductOperation operation, bool left, bool right) {
+    switch (operation) {
+        case AutomatonProductOperation::Intersection: return left && right;
+        case AutomatonProductOperation::Union: return left || right;
+        case AutomatonProductOperation::Difference: return left && !right;
+        case AutomatonProductOperation::SymmetricDifference: return left != right;
+    }
+    return false;
+}
+
+TEST(test_automaton_product, test_automaton_product_random) {
+    RandomRegexConfig config;
+    config.size = 20;
+
+    std::vector<std::string> words = random_words(config.alphabet, 64, 8, 2);
+
+    for (uint64_t seed = 0; seed < 8; seed++) {
+        FiniteAutomaton left = to_nfa(RandomRegexGenerator(config, seed).generate());
+        FiniteAutomaton right = to_nfa(RandomRegexGenerator(config, seed + 100).generate());
+
+        for (auto operation: {AutomatonProductOperation::Intersection, AutomatonProductOperation::Union,
+                              AutomatonProductOperation::Difference,
+                              AutomatonProductOperation::SymmetricDifference}) {
+            for (bool deterministic: {true, false}) {
+                FiniteAutomaton product = AutomatonProduct(left, right, operation, deterministic).build();
+
+                if (deterministic) {
+                    EXPECT_TRUE(product.is_deterministic());
+                }
+
+                for (auto &word: words) {
+                    EXPECT_EQ(product.accepts(word),
+                              apply_operation(operation, left.accepts(word), right.accepts(word)))
+                                        << "Product failed on \"" << word << "\", seed " << seed;
+                }
+            }
+        }
+    }
+}
+
+TEST(test_automaton_product, test_automaton_product_emptiness) {
+    FiniteAutomaton allow = to_nfa(*("a"_r + "b"_r) * "c"_r);
+    FiniteAutomaton deny = to_nfa("b"_r * *"b"_r);
+    FiniteAutomaton other = to_nfa(*"ab"_r * "c"_r);
+
+    EXPECT_TRUE(AutomatonProduct(allow, deny, AutomatonProductOperation::Intersection).is_empty());
+    EXPECT_FALSE(AutomatonProduct(allow, deny, AutomatonProductOperation::Union).is_empty());
+    EXPECT_TRUE(AutomatonProduct(other, allow, AutomatonProductOperation::Difference, false).is_empty());
+    EXPECT_FALSE(AutomatonProduct(allow, other, AutomatonProductOperation::Difference, false).is_empty());
+
+    FiniteAutomaton intersection = AutomatonProduct(allow, other, AutomatonProductOperation::Intersection).build();
+    EXPECT_TRUE(intersection.accepts("ababc"));
+    EXPECT_FALSE(intersection.accepts("bac"));
+    EXPECT_FALSE(intersection.accepts("abab"));
+}
+
+FiniteAutomaton to_dfa(const Regex& regex, const std::set<char>& alphabet = {}) {
+    FiniteAutomaton automaton = to_nfa(regex);
+    automaton.extend_alphabet(alphabet);
+    AutomatonCompleter(automaton).complete();
+    return AutomatonDeterminator(automaton).determine();
+}
+
+std::vector<std::string> all_words(const std::string& alphabet, size_t max_length) {
+    std::vector<std::string> words = {""};
+    for (size_t i = 0; i < words.size(); i++) {
+        if (words[i].size() == max_length) continue;
+        for (char c: alphabet) {
+            words.push_back(words[i] + c);
+        }
+    }
+    return words;
+}
+
+TEST(test_automaton_equivalence, test_automaton_equivalence_equal) {
+    FiniteAutomaton automaton_1 = to_dfa(*("a"_r + "b"_r));
+    FiniteAutomaton automaton_2 = to_dfa(*(*"a"_r * *"b"_r));
+    FiniteAutomaton automaton_3 = AutomatonMinifier(automaton_2).minify();
+
+    EXPECT_TRUE(AutomatonEquivalenceChecker(automaton_1, automaton_2).are_equivalent());
+    EXPECT_TRUE(AutomatonEquivalenceChecker(automaton_1, automaton_3).are_equivalent());
+
+    // Partial DFA against complete one
+    FiniteAutomaton partial;
+    partial.add_state(false);
+    partial.add_state(true);
+    partial.add_transition(0, 1, Regex(CharRegex('a')));
+
+    EXPECT_TRUE(AutomatonEquivalenceChecker(partial, to_dfa("a"_r, {'a', 'b'})).are_equivalent());
+    EXPECT_EQ(AutomatonEquivalenceChecker(partial, to_dfa("a"_r + "ab"_r)).find_counterexample(), "ab");
+}
+
+TEST(test_automaton_equivalence, test_automaton_equivalence_shortest_counterexample) {
+    RandomRegexConfig config;
+    config.size = 16;
+
+    for (uint64_t seed = 0; seed < 20; seed++) {
+        FiniteAutomaton left = to_dfa(RandomRegexGenerator(config, seed).generate(), {'a', 'b'});
+        FiniteAutomaton right = to_dfa(RandomRegexGenerator(config, seed + 1000).generate(), {'a', 'b'});
+
+        auto counterexample = AutomatonEquivalenceChecker(left, right).find_counterexample();
+        size_t max_length = counterexample ? counterexample->size() : 6;
+
+        for (auto &word: all_words("ab", max_length)) {
+            if (counterexample && word.size() == counterexample->size()) break;
+            EXPECT_EQ(left.accepts(word), right.accepts(word)) << "Missed shorter counterexample " << word;
+        }
+
+        if (counterexample) {
+            EXPECT_NE(left.accepts(*counterexample), right.accepts(*counterexample));
+        }
+    }
+}
+
+TEST(test_automaton_inclusion, test_automaton_inclusion_random) {
+    RandomAutomatonConfig config;
+    config.state_count = 8;
+    config.density = 0.6;
+    config.determinism = 0.5;
+    config.final_probability = 0.4;
+
+    for (uint64_t seed = 0; seed < 30; seed++) {
+        FiniteAutomaton left = RandomAutomatonGenerator(config, seed).generate();
+        FiniteAutomaton right = RandomAutomatonGenerator(config, seed + 1000).generate();
+        FiniteAutomaton both = AutomatonProduct(left, right, AutomatonProductOperation::Union, false).build();
+
+        bool expected = AutomatonProduct(left, right, AutomatonProductOperation::Difference).is_empty();
+
+        for (bool use_simulation: {true, false}) {
+            auto counterexample = AutomatonInclusionChecker(left, right, use_simulation).find_counterexample();
+            EXPECT_EQ(!counterexample.has_value(), expected) << "Seed " << seed;
+
+            if (counterexample) {
+                EXPECT_TRUE(left.accepts(*counterexample));
+                EXPECT_FALSE(right.accepts(*counterexample));
+            }
+
+            EXPECT_TRUE(AutomatonInclusionChecker(left, both, use_simulation).is_included());
+            EXPECT_TRUE(AutomatonInclusionChecker(right, both, use_simulation).is_included());
+        }
+    }
+}
+
+TEST(test_automaton_inclusion, test_automaton_universality) {
+    FiniteAutomaton universal = to_nfa(*"a"_r * *("b"_r * *"a"_r) + "b"_r);
+    FiniteAutomaton not_universal = to_nfa(*("a"_r + "b"_r) * "a"_r);
+
+    EXPECT_TRUE(AutomatonUniversalityChecker(universal).is_universal());
+
+    auto counterexample = AutomatonUniversalityChecker(not_universal).find_counterexample();
+    ASSERT_TRUE(counterexample.has_value());
+    EXPECT_FALSE(not_universal.accepts(*counterexample));
+}
+
+TEST(test_regex_derivative, test_regex_derivative_normalization) {
+    Regex regex = RegexDerivative::normalize(("b"_r + "a"_r) + ("a"_r + Regex::zero()) * *(*"c"_r));
+
+    EXPECT_EQ(regex_to_string(regex), "(a + b + a(c)*)");
+    EXPECT_EQ(regex_to_string(RegexDerivative::normalize(SumRegex{{"b"_r, SumRegex{{"a"_r, Regex::zero()}}, "b"_r}})), "(a + b)");
+    EXPECT_EQ(regex_to_string(RegexDerivative::derive(RegexDerivative::normalize(*"ab"_r), 'a')), "b(ab)*");
+    EXPECT_TRUE(RegexDerivative::derive(RegexDerivative::normalize("ab"_r), 'b').is_zero());
+    EXPECT_TRUE(RegexDerivative::is_nullable(RegexDerivative::normalize(*"a"_r * (Regex::empty() + "b"_r))));
+}
+
+TEST(test_regex_derivative, test_derivative_automaton_random) {
+    RandomRegexConfig config;
+    config.size = 30;
+
+    std::vector<std::string> words = random_words("abc", 64, 10, 3);
+
+    for (uint64_t seed = 0; seed < 20; seed++) {
+        Regex regex = RandomRegexGenerator(config, seed).generate();
+        FiniteAutomaton expected = to_dfa(regex, {'a', 'b'});
+        FiniteAutomaton automaton = DerivativeAutomatonBuilder(regex, {'a', 'b'}).build();
+
+        EXPECT_TRUE(automaton.is_deterministic());
+        EXPECT_TRUE(automaton.is_complete());
+        EXPECT_TRUE(AutomatonEquivalenceChecker(automaton, expected).are_equivalent()) << "Seed " << seed;
+
+        LazyDerivativeMatcher matcher(regex);
+        for (auto &word: words) {
+            EXPECT_EQ(matcher.accepts(word), expected.accepts(word)) << "Seed " << seed << ", word " << word;
+        }
+    }
+}
+
+TEST(test_regex_derivative, test_derivative_automaton_is_small) {
+    Regex regex = "a"_r * *(*("ba"_r) * "a"_r * *("ab"_r) + "a"_r);
+
+    FiniteAutomaton automaton = DerivativeAutomatonBuilder(regex).build();
+    FiniteAutomaton minimal = AutomatonMinifier(automaton).minify();
+
+    EXPECT_TRUE(AutomatonEquivalenceChecker(automaton, to_dfa(regex)).are_equivalent());
+    EXPECT_LE(automaton.get_states().size(), 2 * minimal.get_states().size());
+}
+
+TEST(test_glushkov_automaton, test_glushkov_automaton_shape) {
+    FiniteAutomaton automaton = GlushkovAutomatonBuilder(*("ab"_r + "b"_r) * "a"_r).build();
+
+    EXPECT_EQ(automaton.get_states().size(), 5);
+    EXPECT_TRUE(automaton.is_simple());
+    EXPECT_FALSE(automaton.has_epsilon_transitions());
+
+    EXPECT_TRUE(automaton.accepts("a"));
+    EXPECT_TRUE(automaton.accepts("abba"));
+    EXPECT_TRUE(automaton.accepts("aba"));
+    EXPECT_FALSE(automaton.accepts("abab"));
+    EXPECT_FALSE(automaton.accepts(""));
+}
+
+TEST(test_glushkov_automaton, test_glushkov_automaton_random) {
+    RandomRegexConfig config;
+    config.size = 30;
+
+    for (uint64_t seed = 0; seed < 20; seed++) {
+        Regex regex = RandomRegexGenerator(config, seed).generate();
+
+        FiniteAutomaton automaton = GlushkovAutomatonBuilder(regex, {'a', 'b'}).build();
+        EXPECT_FALSE(automaton.has_epsilon_transitions());
+
+        AutomatonCompleter(automaton).complete();
+        automaton = AutomatonDeterminator(automaton).determine();
+
+        EXPECT_TRUE(AutomatonEquivalenceChecker(automaton, to_dfa(regex, {'a', 'b'})).are_equivalent())
+                            << "Seed " << seed;
+    }
+}
+
+TEST(test_antimirov_automaton, test_antimirov_automaton_shape) {
+    // Position automaton has 5 states here, partial derivatives only need 3
+    Regex regex = *("ab"_r + "b"_r) * "a"_r;
+    FiniteAutomaton automaton = AntimirovAutomatonBuilder(regex).build();
+
+    EXPECT_EQ(automaton.get_states().size(), 3);
+    EXPECT_LE(automaton.get_states().size(), GlushkovAutomatonBuilder(regex).build().get_states().size());
+    EXPECT_FALSE(automaton.has_epsilon_transitions());
+
+    auto terms = RegexDerivative::derive_partial(RegexDerivative::normalize("a"_r * ("b"_r + "c"_r) + "ab"_r), 'a');
+    EXPECT_EQ(terms.size(), 2);
+}
+
+TEST(test_antimirov_automaton, test_antimirov_automaton_random) {
+    RandomRegexConfig config;
+    config.size = 30;
+
+    for (uint64_t seed = 0; seed < 20; seed++) {
+        Regex regex = RandomRegexGenerator(config, seed).generate();
+
+        FiniteAutomaton automaton = AntimirovAutomatonBuilder(regex, {'a', 'b'}).build();
+        EXPECT_LE(automaton.get_states().size(), GlushkovAutomatonBuilder(regex).build().get_states().size());
+
+        AutomatonCompleter(automaton).complete();
+        automaton = AutomatonDeterminator(automaton).determine();
+
+        EXPECT_TRUE(AutomatonEquivalenceChecker(automaton, to_dfa(regex, {'a', 'b'})).are_equivalent())
+                            << "Seed " << seed;
+    }
+}
+
+TEST(test_parallel_determinator, test_parallel_determinator_random) {
+    RandomAutomatonConfig config;
+    config.state_count = 12;
+    config.density = 0.6;
+    config.determinism = 0.4;
+
+    ThreadPool pool(4);
+    ThreadPool single_thread_pool(1);
+
+    for (uint64_t seed = 0; seed < 10; seed++) {
+        FiniteAutomaton automaton = RandomAutomatonGenerator(config, seed).generate();
+        AutomatonCompleter(automaton).complete();
+
+        FiniteAutomaton serial = AutomatonDeterminator(automaton).determine();
+        FiniteAutomaton parallel = ParallelAutomatonDeterminator(automaton, pool).determine();
+
+        EXPECT_TRUE(parallel.is_deterministic());
+        EXPECT_TRUE(parallel.is_complete());
+        EXPECT_EQ(parallel.get_states().size(), serial.get_states().size());
+        EXPECT_TRUE(AutomatonEquivalenceChecker(parallel, serial).are_equivalent()) << "Seed " << seed;
+
+        FiniteAutomaton single_threaded = ParallelAutomatonDeterminator(automaton, single_thread_pool).determine();
+        EXPECT_EQ(automaton_to_string(parallel), automaton_to_string(single_threaded)) << "Seed " << seed;
+    }
+}
+
+TEST(test_parallel_determinator, test_thread_pool) {
+    ThreadPool pool(3);
+    std::vector<std::atomic<int>> counters(1000);
+
+    for (int round = 0; round < 5; round++) {
+        pool.parallel_for(counters.size(), [&](size_t index, size_t thread_index) {
+            EXPECT_LT(thread_index, 3);
+            counters[index]++;
+        }, 7);
+    }
+
+    for (auto &counter: counters) {
+        EXPECT_EQ(counter, 5);
+    }
+}
+
+TEST(test_parallel_minifier, test_parallel_minifier_random) {
+    RandomAutomatonConfig config;
+    config.state_count = 300;
+    config.density = 1.0;
+    config.final_probability = 0.3;
+
+    ThreadPool pool(4);
+
+    for (uint64_t seed = 0; seed < 5; seed++) {
+        FiniteAutomaton automaton = RandomAutomatonGenerator(config, seed).generate();
+        ASSERT_TRUE(automaton.is_complete());
+
+        FiniteAutomaton serial = AutomatonMinifier(automaton).minify();
+        FiniteAutomaton parallel = ParallelAutomatonMinifier(automaton, pool).minify();
+
+        EXPECT_EQ(automaton_to_string(parallel), automaton_to_string(serial)) << "Seed " << seed;
+        EXPECT_TRUE(AutomatonEquivalenceChecker(parallel, automaton).are_equivalent());
+    }
+}
+
+TEST(test_parallel_minifier, test_minifier_without_final_states) {
+    FiniteAutomaton automaton = to_dfa("a"_r);
+    for (size_t i = 0; i < automaton.get_states().size(); i++) {
+        automaton.make_state_final(i, false);
+    }
+
+    ThreadPool pool(2);
+
+    EXPECT_EQ(AutomatonMinifier(automaton).minify().get_states().size(), 1);
+    EXPECT_EQ(ParallelAutomatonMinifier(automaton, pool).minify().get_states().size(), 1);
+}
+
+TEST(test_partial_automaton, test_partial_pipeline) {
+    RandomRegexConfig config;
+    config.size = 30;
+
+    ThreadPool pool(3);
+
+    for (uint64_t seed = 0; seed < 20; seed++) {
+        Regex regex = RandomRegexGenerator(config, seed).generate();
+
+        FiniteAutomaton partial = to_nfa(regex);
+        partial.extend_alphabet({'a', 'b'});
+        partial = AutomatonDeterminator(partial).determine();
+        EXPECT_TRUE(partial.is_deterministic());
+
+        FiniteAutomaton complete = to_dfa(regex, {'a', 'b'});
+        FiniteAutomaton minimal_complete = AutomatonMinifier(complete).minify();
+        FiniteAutomaton minimal_partial = AutomatonMinifier(partial).minify();
+
+        EXPECT_TRUE(minimal_complete.is_complete());
+        EXPECT_TRUE(AutomatonEquivalenceChecker(minimal_partial, complete).are_equivalent()) << "Seed " << seed;
+        EXPECT_LE(minimal_partial.get_states().size(), minimal_complete.get_states().size());
+        EXPECT_GE(minimal_partial.get_states().size() + 1, minimal_complete.get_states().size());
+
+        EXPECT_EQ(automaton_to_string(ParallelAutomatonMinifier(partial, pool).minify()),
+                  automaton_to_string(minimal_partial)) << "Seed " << seed;
+    }
+}
+
+TEST(test_partial_automaton, test_partial_inversion) {
+    FiniteAutomaton automaton = to_nfa("ab"_r);
+    automaton = AutomatonDeterminator(automaton).determine();
+    automaton = AutomatonMinifier(automaton).minify();
+
+    EXPECT_EQ(automaton.get_states().size(), 3);
+    EXPECT_FALSE(automaton.is_complete());
+
+    AutomatonInverter(automaton).invert();
+
+    EXPECT_TRUE(automaton.is_complete());
+    EXPECT_EQ(automaton.get_states().size(), 4);
+    EXPECT_TRUE(automaton.accepts(""));
+    EXPECT_TRUE(automaton.accepts("a"));
+    EXPECT_TRUE(automaton.accepts("b"));
+    EXPECT_FALSE(automaton.accepts("ab"));
+    EXPECT_TRUE(automaton.accepts("abb"));
+
+    // A letter without transitions is still a letter of the complement
+    FiniteAutomaton partial;
+    partial.add_state(false);
+    partial.add_state(true);
+    partial.add_transition(0, 1, Regex(CharRegex('a')));
+    partial.extend_alphabet({'a', 'b'});
+
+    FiniteAutomaton complement = AutomatonDeterminator(partial).determine();
+    EXPECT_EQ(complement.alphabet, std::set<char>({'a', 'b'}));
+    AutomatonInverter(complement).invert();
+
+    EXPECT_TRUE(complement.accepts(""));
+    EXPECT_FALSE(complement.accepts("a"));
+    EXPECT_TRUE(complement.accepts("b"));
+    EXPECT_TRUE(complement.accepts("ab"));
+    EXPECT_TRUE(complement.accepts("ba"));
+
+    // Empty language collapses into a single state without transitions
+    FiniteAutomaton empty;
+    empty.add_state(false);
+    empty.add_state(false);
+    empty.add_transition(0, 1, Regex(CharRegex('a')));
+
+    FiniteAutomaton minimal = AutomatonMinifier(empty).minify();
+    EXPECT_EQ(minimal.get_states().size(), 1);
+    EXPECT_TRUE(minimal.get_states()[0].transitions.empty());
+}
+
+Regex nth_from_end_regex(size_t n) {
+    // (a + b)*a(a + b)^(n - 1): the minimal DFA has 2^n states
+    Regex any = "a"_r + "b"_r;
+    Regex regex = *Regex(any) * "a"_r;
+    for (size_t i = 1; i < n; i++) {
+        regex *= any;
+    }
+    return regex;
+}
+
+TEST(test_pattern_compiler, test_compiled_dfa) {
+    FiniteAutomaton automaton = to_nfa(*("ab"_r + "c"_r + "d"_r) * "e"_r);
+    automaton = AutomatonDeterminator(automaton).determine();
+    automaton = AutomatonMinifier(automaton).minify();
+
+    CompiledDfa dfa(automaton);
+
+    // c and d behave the same, unknown bytes share class 0
+    EXPECT_EQ(dfa.get_byte_class('c'), dfa.get_byte_class('d'));
+    EXPECT_EQ(dfa.get_byte_class('x'), 0);
+    EXPECT_EQ(dfa.get_class_count(), 5);
+
+    for (auto &word: random_words("abcdex", 200, 8, 4)) {
+        EXPECT_EQ(dfa.accepts(word), automaton.accepts(word)) << word;
+    }
+}
+
+TEST(test_pattern_compiler, test_determinization_limits) {
+    FiniteAutomaton automaton = GlushkovAutomatonBuilder(nth_from_end_regex(10)).build();
+
+    AutomatonDeterminator limited(automaton, {100, SIZE_MAX, SIZE_MAX});
+    EXPECT_FALSE(limited.try_determine().has_value());
+    EXPECT_TRUE(limited.limit_exceeded);
+
+    AutomatonDeterminator limited_bytes(automaton, {SIZE_MAX, SIZE_MAX, 10000});
+    EXPECT_FALSE(limited_bytes.try_determine().has_value());
+
+    auto dfa = AutomatonDeterminator(automaton, {2000, SIZE_MAX, SIZE_MAX}).try_determine();
+    ASSERT_TRUE(dfa.has_value());
+    EXPECT_EQ(AutomatonMinifier(*dfa).minify().get_states().size(), 1024);
+}
+
+TEST(test_pattern_compiler, test_pattern_fallback) {
+    PatternCompilerOptions options;
+    options.limits.max_states = 256;
+    options.lazy_cache_states = 64;
+
+    CompiledPattern small = PatternCompiler(nth_from_end_regex(4), options).compile();
+    CompiledPattern large = PatternCompiler(nth_from_end_regex(12), options).compile();
+
+    EXPECT_EQ(small.get_engine(), PatternEngine::Dfa);
+    EXPECT_EQ(small.get_stats().minimal_states, 16);
+    EXPECT_FALSE(small.get_stats().used_fallback());
+
+    EXPECT_EQ(large.get_engine(), PatternEngine::LazyDfa);
+    EXPECT_TRUE(large.get_stats().used_fallback());
+    EXPECT_FALSE(large.get_stats().fallback_reason.empty());
+
+    FiniteAutomaton expected = GlushkovAutomatonBuilder(nth_from_end_regex(12)).build();
+    for (auto &word: random_words("ab", 100, 40, 5)) {
+        EXPECT_EQ(large.accepts(word), expected.accepts(word)) << word;
+    }
+}
+
+TEST(test_pipeline_control, test_cancellation) {
+    FiniteAutomaton automaton = GlushkovAutomatonBuilder(nth_from_end_regex(10)).build();
+
+    CancellationToken token;
+    PipelineControl control;
+    control.set_cancellation_token(token);
+
+    size_t reports = 0;
+    control.set_progress_callback([&](const PipelineProgress &progress) {
+        if (++reports == 3) {
+            token.cancel();
+        }
+    }, std::chrono::steady_clock::duration::zero());
+
+    AutomatonDeterminator determinator(automaton, {}, &control);
+    EXPECT_FALSE(determinator.try_determine().has_value());
+    EXPECT_TRUE(determinator.is_stopped());
+    EXPECT_EQ(control.get_stop_reason(), PipelineStopReason::Cancelled);
+    EXPECT_EQ(reports, 3);
+
+    PatternCompilerOptions options;
+    options.control = &control;
+
+    CompiledPattern pattern = PatternCompiler(nth_from_end_regex(4), options).compile();
+    EXPECT_EQ(pattern.get_engine(), PatternEngine::LazyDfa);
+    EXPECT_EQ(pattern.get_stats().fallback_reason, "compilation was cancelled");
+    EXPECT_TRUE(pattern.accepts("abbb"));
+    EXPECT_FALSE(pattern.accepts("abbbb"));
+}
+
+TEST(test_pipeline_control, test_cancellation_keeps_set_semantics) {
+    // Both stages turn the set semantics off while they run
+    Regex regex = *("ab"_r + "c"_r + "ba"_r) * nth_from_end_regex(4);
+
+    for (bool remove_epsilon: {false, true}) {
+        FiniteAutomaton automaton(regex);
+        if (remove_epsilon) {
+            AutomatonSimplifier(automaton).simplify();
+        }
+        automaton.set_unique_transitions(true);
+
+        CancellationToken token;
+        PipelineControl control;
+        control.set_cancellation_token(token);
+
+        size_t reports = 0;
+        control.set_progress_callback([&](const PipelineProgress &progress) {
+            if (++reports == 2) {
+                token.cancel();
+            }
+        }, std::chrono::steady_clock::duration::zero());
+
+        if (remove_epsilon) {
+            EpsilonRemover(automaton, &control).simplify();
+        } else {
+            AutomatonSimplifier(automaton, &control).simplify();
+        }
+
+        EXPECT_TRUE(control.is_stopped()) << remove_epsilon;
+        EXPECT_TRUE(automaton.has_unique_transitions()) << remove_epsilon;
+    }
+
+    // A determinization over its limits hands back an automaton in the usual mode
+    FiniteAutomaton nfa = GlushkovAutomatonBuilder(nth_from_end_regex(10)).build();
+    DeterminizationLimits limits;
+    limits.max_states = 16;
+    AutomatonDeterminator determinator(nfa, limits);
+    FiniteAutomaton result = determinator.determine();
+    EXPECT_TRUE(determinator.limit_exceeded);
+    EXPECT_FALSE(result.has_unique_transitions());
+}
+
+TEST(test_pipeline_control, test_deadline) {
+    FiniteAutomaton automaton = GlushkovAutomatonBuilder(nth_from_end_regex(10)).build();
+
+    PipelineControl control;
+    control.set_timeout(std::chrono::steady_clock::duration::zero());
+
+    // The stopped stages return the empty language, which is still safe to run
+    FiniteAutomaton stopped = AutomatonDeterminator(automaton, {}, &control).determine();
+    EXPECT_EQ(stopped.get_states().size(), 1);
+    EXPECT_FALSE(stopped.accepts("a"));
+    EXPECT_EQ(control.get_stop_reason(), PipelineStopReason::DeadlineExceeded);
+
+    FiniteAutomaton dfa = AutomatonDeterminator(automaton).determine();
+    FiniteAutomaton minimal = AutomatonMinifier(dfa, &control).minify();
+    EXPECT_EQ(minimal.get_states().size(), 1);
+    EXPECT_FALSE(minimal.accepts("b" + std::string(9, 'a')));
+}
+
+TEST(test_pipeline_control, test_progress) {
+    FiniteAutomaton automaton = to_nfa(*("ab"_r + "c"_r) * "a"_r);
+
+    PipelineControl control;
+    std::vector<PipelineProgress> reports;
+    control.set_progress_callback([&](const PipelineProgress &progress) {
+        reports.push_back(progress);
+    }, std::chrono::steady_clock::duration::zero());
+
+    automaton = AutomatonDeterminator(automaton, {}, &control).determine();
+    AutomatonMinifier(automaton, &control).minify();
+
+    ASSERT_FALSE(reports.empty());
+    EXPECT_EQ(std::string(reports.back().stage), "minify");
+    EXPECT_EQ(reports.back().remaining, 0);
+
+    size_t finished_stages = 0;
+    for (auto &progress: reports) {
+        if (progress.remaining == 0) {
+            finished_stages++;
+        }
+    }
+    EXPECT_EQ(finished_stages, 2);
+    EXPECT_FALSE(control.is_stopped());
+}
+
+TEST(test_automaton_optimizer, test_trim) {
+    // 0 -a-> 1 (final), 0 -b-> 2 -a-> 2 is a trap, 3 is unreachable
+    FiniteAutomaton automaton;
+    automaton.add_state(false);
+    automaton.add_state(true);
+    automaton.add_state(false);
+    automaton.add_state(true);
+    automaton.add_transition(0, 1, Regex(CharRegex('a')));
+    automaton.add_transition(0, 2, Regex(CharRegex('b')));
+    automaton.add_transition(2, 2, Regex(CharRegex('a')));
+    automaton.add_transition(3, 1, Regex(CharRegex('a')));
+
+    AutomatonOptimizer(automaton).trim();
+    EXPECT_EQ(automaton.get_states().size(), 2);
+    EXPECT_TRUE(automaton.accepts("a"));
+    EXPECT_FALSE(automaton.accepts("ba"));
+
+    // The start state stays even when the language is empty
+    FiniteAutomaton empty;
+    empty.add_state(false);
+    empty.add_state(false);
+    empty.add_transition(0, 1, Regex(CharRegex('a')));
+    AutomatonOptimizer(empty).trim();
+    EXPECT_EQ(empty.get_states().size(), 1);
+    EXPECT_TRUE(empty.get_states()[0].transitions.empty());
+
+    RandomAutomatonConfig config;
+    config.state_count = 60;
+    config.determinism = 0.7;
+    config.final_probability = 0.05;
+
+    for (uint64_t seed = 0; seed < 10; seed++) {
+        FiniteAutomaton random = RandomAutomatonGenerator(config, seed).generate();
+        FiniteAutomaton trimmed = random;
+        AutomatonOptimizer(trimmed).trim();
+
+        EXPECT_LE(trimmed.get_states().size(), random.get_states().size());
+        for (auto &word: random_words(config.alphabet, 50, 10, seed)) {
+            EXPECT_EQ(trimmed.accepts(word), random.accepts(word)) << word;
+        }
+    }
+}
+
+TEST(test_finite_automaton, test_canonicalize) {
+    FiniteAutomaton automaton;
+    automaton.add_state(false);
+    automaton.add_state(true);
+    automaton.add_transition(0, 1, Regex(CharRegex('b')));
+    automaton.add_transition(0, 1, Regex(CharRegex('a')));
+    automaton.add_transition(0, 0, Regex(CharRegex('b')));
+    automaton.add_transition(0, 1, Regex(CharRegex('b')));
+    EXPECT_EQ(automaton.get_states()[0].transitions.size(), 4);
+
+    automaton.canonicalize();
+    auto &transitions = automaton.get_states()[0].transitions;
+    ASSERT_EQ(transitions.size(), 3);
+    EXPECT_TRUE(std::is_sorted(transitions.begin(), transitions.end()));
+
+    automaton.set_unique_transitions(true);
+    automaton.add_transition(0, 1, Regex(CharRegex('a')));
+    automaton.add_transition(0, 0, Regex(CharRegex('a')));
+    EXPECT_EQ(transitions.size(), 4);
+    EXPECT_TRUE(std::is_sorted(transitions.begin(), transitions.end()));
+
+    // (a + a)* used to leave a duplicate a-transition after simplification
+    FiniteAutomaton nfa = to_nfa(*("a"_r + "a"_r));
+    for (auto &state: nfa.get_states()) {
+        EXPECT_TRUE(std::adjacent_find(state.transitions.begin(), state.transitions.end()) == state.transitions.end());
+    }
+    EXPECT_TRUE(nfa.accepts("aaa"));
+}
+
+TEST(test_brzozowski_minifier, test_reverse) {
+    FiniteAutomaton automaton = GlushkovAutomatonBuilder("ab"_r * *"c"_r + "ba"_r).build();
+    AutomatonReverser reverser(automaton);
+    FiniteAutomaton reversed = reverser.reverse();
+
+    EXPECT_FALSE(reversed.has_epsilon_transitions());
+    EXPECT_EQ(reversed.get_start_state_index(), automaton.get_states().size());
+    EXPECT_EQ(reverser.get_start_states().size(), 3);
+
+    for (auto &word: random_words("abc", 200, 6, 6)) {
+        std::string reversed_word(word.rbegin(), word.rend());
+        EXPECT_EQ(reversed.accepts(reversed_word), automaton.accepts(word)) << word;
+    }
+
+    // The empty word survives the reversal
+    FiniteAutomaton nullable = GlushkovAutomatonBuilder(*"ab"_r).build();
+    EXPECT_TRUE(AutomatonReverser(nullable).reverse().accepts(""));
+}
+
+TEST(test_brzozowski_minifier, test_minify) {
+    RandomRegexConfig config;
+    config.size = 24;
+
+    for (uint64_t seed = 0; seed < 20; seed++) {
+        Regex regex = RandomRegexGenerator(config, seed).generate();
+        FiniteAutomaton nfa = GlushkovAutomatonBuilder(regex, {'a', 'b'}).build();
+
+        FiniteAutomaton dfa = AutomatonDeterminator(nfa).determine();
+        AutomatonOptimizer(dfa).trim();
+        FiniteAutomaton expected = AutomatonMinifier(dfa).minify();
+        FiniteAutomaton minimal = BrzozowskiMinifier(nfa).minify();
+
+        EXPECT_TRUE(minimal.is_deterministic());
+        EXPECT_EQ(minimal.get_states().size(), expected.get_states().size()) << "seed " << seed;
+        EXPECT_TRUE(AutomatonEquivalenceChecker(minimal, expected).are_equivalent()) << "seed " << seed;
+    }
+
+    FiniteAutomaton nth = GlushkovAutomatonBuilder(nth_from_end_regex(6)).build();
+    EXPECT_EQ(BrzozowskiMinifier(nth).minify().get_states().size(), 64);
+}
+
+TEST(test_regex_parser, test_round_trip) {
+    RandomRegexConfig config;
+    config.alphabet = "abc";
+    config.size = 24;
+
+    for (uint64_t seed = 0; seed < 20; seed++) {
+        Regex regex = RandomRegexGenerator(config, seed).generate();
+        std::string text = regex_to_string(regex);
+
+        RegexParser parser(text);
+        std::optional<Regex> parsed = parser.parse();
+        ASSERT_TRUE(parsed.has_value()) << text << ": " << parser.get_error();
+        EXPECT_EQ(regex_to_string(*parsed), text);
+    }
+
+    EXPECT_EQ(regex_to_string(*RegexParser("a ((b + c))* ε").parse()), "a((b + c))*ε");
+    EXPECT_TRUE(RegexParser("()").parse()->is_zero());
+
+    RegexParser invalid("a(b + c");
+    EXPECT_FALSE(invalid.parse().has_value());
+    EXPECT_FALSE(invalid.get_error().empty());
+    EXPECT_FALSE(RegexParser("a)").parse().has_value());
+    EXPECT_FALSE(RegexParser("*a").parse().has_value());
+    EXPECT_FALSE(RegexParser("(a + )").parse().has_value());
+}
+
+TEST(test_automaton_cpp_printer, test_generated_matchers) {
+    // Both headers are generated at build time from a((b + c))*d
+    FiniteAutomaton expected = GlushkovAutomatonBuilder(*RegexParser("a((b + c))*d").parse()).build();
+
+    for (auto &word: random_words("abcdx", 300, 8, 7)) {
+        EXPECT_EQ(generated_switch_matcher(word), expected.accepts(word)) << word;
+        EXPECT_EQ(generated_table_matcher(word), expected.accepts(word)) << word;
+    }
+
+    FiniteAutomaton dfa = AutomatonDeterminator(expected).determine();
+    dfa = AutomatonMinifier(dfa).minify();
+    std::stringstream code;
+    code << AutomatonCppPrinter(dfa, "matcher", AutomatonCppStyle::Table);
+    EXPECT_NE(code.str().find("bool matcher(std::string_view input)"), std::string::npos);
+    EXPECT_NE(code.str().find("static constexpr uint8_t transitions"), std::string::npos);
+}
+
+// Checked while compiling the tests
+static_assert(static_match<"a((b + c))*d">("abcbd"));
+static_assert(!static_match<"a((b + c))*d">("abx"));
+static_assert(static_match<"(ε + ab)">(""));
+static_assert(!static_match<"a()">("a"));
+static_assert(StaticRegex<"((a + b))*a(a + b)(a + b)">::dfa.state_count == 9);
+
+TEST(test_static_regex, test_matches_runtime_automaton) {
+    using Pattern = StaticRegex<"((ab + b))*a((c + ε))*">;
+    FiniteAutomaton expected = GlushkovAutomatonBuilder(*RegexParser("((ab + b))*a((c + ε))*").parse()).build();
+
+    for (auto &word: random_words("abcd", 300, 8, 8)) {
+        EXPECT_EQ(Pattern::match(word), expected.accepts(word)) << word;
+    }
+
+    // The dead state and a single live one
+    EXPECT_EQ(StaticRegex<"((a + b))*">::dfa.state_count, 2);
+    EXPECT_TRUE(StaticRegex<"((a + b))*">::match("abba"));
+}
+
+// Patterns every matching engine is checked on, next to its own ones
+std::vector<Regex> engine_test_patterns() {
+    return {*("ab"_r + "c"_r) * "d"_r, Regex::empty(), Regex::zero()};
+}
+
+// Compares a matching engine with the table of the DFA it was built from, on
+// words longer than a vector and with letters outside of the alphabet
+void expect_matches_table(const CompiledDfa &dfa, const std::function<bool(std::string_view)> &accepts,
+                          const std::string &description) {
+    EXPECT_EQ(accepts(""), dfa.accepts("")) << description;
+    for (auto &word: random_words("abcdegxz", 300, 80, 9)) {
+        EXPECT_EQ(accepts(word), dfa.accepts(word)) << description << " " << word;
+    }
+}
+
+TEST(test_jit_compiled_dfa, test_matches_table) {
+    std::vector<Regex> patterns = engine_test_patterns();
+    patterns.push_back(nth_from_end_regex(5));
+
+    // Enough distinct byte ranges in one state to get a jump table
+    Regex letters = Regex::zero();
+    for (char c = 'a'; c <= 'z'; c += 2) {
+        letters += Regex(CharRegex(c));
+    }
+    patterns.push_back(*letters * "b"_r);
+
+    for (auto &regex: patterns) {
+        CompiledPattern pattern = PatternCompiler(regex).compile();
+        JitCompiledDfa jit(pattern.get_dfa());
+
+#if defined(__x86_64__) && defined(__linux__)
+        EXPECT_TRUE(jit.is_native());
+#endif
+
+        expect_matches_table(pattern.get_dfa(), [&](std::string_view word) { return jit.accepts(word); },
+                             regex_to_string(regex));
+    }
+
+    PatternCompilerOptions options;
+    options.jit = true;
+    CompiledPattern pattern = PatternCompiler(nth_from_end_regex(3), options).compile();
+    JitCompiledDfa moved = JitCompiledDfa(pattern.get_dfa());
+    EXPECT_TRUE(pattern.accepts("abb"));
+    EXPECT_FALSE(pattern.accepts("bbb"));
+    EXPECT_TRUE(moved.accepts("aab"));
+}
+
+TEST(test_pattern_searcher, test_literal_analysis) {
+    RegexLiterals literals = RegexLiteralAnalyzer("ab"_r * *"c"_r * "def"_r * ("fg"_r + "xfg"_r)).analyze();
+    EXPECT_EQ(literals.prefix, "ab");
+    EXPECT_EQ(literals.suffix, "fg");
+    EXPECT_EQ(literals.required, "def");
+    EXPECT_FALSE(literals.exact.has_value());
+    EXPECT_EQ(literals.max_length, SIZE_MAX);
+
+    literals = RegexLiteralAnalyzer(("a"_r + "b"_r) * "hello"_r * ("c"_r + Regex::empty())).analyze();
+    EXPECT_EQ(literals.prefix, "");
+    EXPECT_EQ(literals.suffix, "");
+    EXPECT_EQ(literals.required, "hello");
+    EXPECT_EQ(literals.max_length, 7);
+
+    literals = RegexLiteralAnalyzer("abc"_r).analyze();
+    EXPECT_EQ(literals.exact, "abc");
+
+    EXPECT_TRUE(RegexLiteralAnalyzer(Regex::zero()).analyze().is_empty_language);
+    EXPECT_EQ(RegexLiteralAnalyzer("xay"_r + "zaw"_r).analyze().required, "a");
+}
+
+// The first match to end, and the longest of those
+std::optional<PatternMatch> find_match(const FiniteAutomaton &automaton, std::string_view text) {
+    for (size_t end = 0; end <= text.size(); end++) {
+        for (size_t begin = 0; begin <= end; begin++) {
+            if (automaton.accepts(text.substr(begin, end - begin))) {
+                return PatternMatch{begin, end};
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+TEST(test_pattern_searcher, test_matches_brute_force) {
+    std::vector<std::pair<Regex, PatternSearchStrategy>> patterns = {
+            {"ab"_r * *"c"_r,                         PatternSearchStrategy::Prefix},
+            {*("a"_r + "b"_r) * "cb"_r,               PatternSearchStrategy::Suffix},
+            {("a"_r + "b"_r) * "cc"_r * ("a"_r + "d"_r), PatternSearchStrategy::Inner},
+            {*"a"_r * "b"_r * *"d"_r * "c"_r * *"a"_r, PatternSearchStrategy::Inner},
+            {*("ab"_r + "ba"_r),                      PatternSearchStrategy::Unanchored},
+            {Regex::zero(),                           PatternSearchStrategy::Unanchored},
+    };
+
+    std::vector<std::string> texts = random_words("abcdx", 150, 16, 10);
+
+    // Every DFA but the one of the empty language is past these limits
+    PatternCompilerOptions small_limits;
+    small_limits.limits.max_states = 1;
+    small_limits.lazy_cache_states = 4;
+
+    for (auto &[regex, strategy]: patterns) {
+        FiniteAutomaton automaton = GlushkovAutomatonBuilder(regex).build();
+        PatternSearcher searcher(regex);
+        PatternSearcher plain(regex, false);
+        PatternSearcher lazy(regex, true, small_limits);
+
+        EXPECT_EQ(searcher.get_strategy(), strategy) << regex_to_string(regex);
+        EXPECT_TRUE(searcher.get_fallback_reason().empty());
+        EXPECT_EQ(lazy.get_fallback_reason().empty(), regex.is_zero()) << regex_to_string(regex);
+
+        for (auto &text: texts) {
+            std::optional<PatternMatch> expected = find_match(automaton, text);
+            EXPECT_EQ(searcher.find(text), expected) << regex_to_string(regex) << " in " << text;
+            EXPECT_EQ(plain.find(text), expected) << regex_to_string(regex) << " in " << text;
+            EXPECT_EQ(lazy.find(text), expected) << regex_to_string(regex) << " in " << text;
+        }
+    }
+}
+
+TEST(test_pattern_searcher, test_many_literal_hits) {
+    // Every byte is an occurrence of the literal and no match exists, which
+    // takes hours if each occurrence is verified by its own run
+    std::vector<std::tuple<Regex, PatternSearchStrategy, char>> patterns = {
+            {"a"_r * *("a"_r + "b"_r) * "c"_r, PatternSearchStrategy::Prefix, 'a'},
+            {("a"_r + "b"_r) * *"c"_r * "c"_r, PatternSearchStrategy::Suffix, 'c'},
+    };
+
+    for (auto &[regex, strategy, letter]: patterns) {
+        PatternSearcher searcher(regex);
+        ASSERT_EQ(searcher.get_strategy(), strategy) << regex_to_string(regex);
+
+        std::string text(1 << 20, letter);
+        EXPECT_EQ(searcher.find(text), std::nullopt);
+
+        // A match at the very end is still found: all of the text for the
+        // prefix, and the last two bytes for the suffix
+        size_t begin = letter == 'a' ? 0 : text.size() - 2;
+        text[begin] = letter == 'a' ? 'a' : 'b';
+        text.back() = 'c';
+        EXPECT_EQ(searcher.find(text), (PatternMatch{begin, text.size()}));
+    }
+
+    // Candidates which fail at once, the pass jumps from each to the next one
+    PatternSearcher inner(("a"_r + "b"_r) * "cc"_r * ("a"_r + "d"_r));
+    ASSERT_EQ(inner.get_strategy(), PatternSearchStrategy::Inner);
+
+    std::string text;
+    for (size_t i = 0; i < (1 << 18); i++) {
+        text += "xaccxx";
+    }
+    EXPECT_EQ(inner.find(text), std::nullopt);
+
+    text += "bccd";
+    EXPECT_EQ(inner.find(text), (PatternMatch{text.size() - 4, text.size()}));
+}
+
+TEST(test_sheng_dfa, test_matches_table) {
+    std::vector<Regex> patterns = engine_test_patterns();
+    patterns.push_back(nth_from_end_regex(3));
+
+    for (auto &regex: patterns) {
+        CompiledPattern pattern = PatternCompiler(regex).compile();
+        ASSERT_TRUE(ShengDfa::fits(pattern.get_dfa()));
+
+        ShengDfa sheng(pattern.get_dfa());
+        EXPECT_EQ(sheng.is_vectorized(), ShengDfa::is_supported());
+        EXPECT_EQ(pattern.get_engine(), ShengDfa::is_supported() ? PatternEngine::Sheng : PatternEngine::Dfa);
+
+        expect_matches_table(pattern.get_dfa(), [&](std::string_view word) { return sheng.accepts(word); },
+                             regex_to_string(regex));
+        expect_matches_table(pattern.get_dfa(), [&](std::string_view word) { return pattern.accepts(word); },
+                             regex_to_string(regex));
+    }
+
+    // 16 states and the dead one don't fit
+    CompiledPattern large = PatternCompiler(nth_from_end_regex(4)).compile();
+    EXPECT_FALSE(ShengDfa::fits(large.get_dfa()));
+    EXPECT_EQ(large.get_engine(), PatternEngine::Dfa);
+    EXPECT_FALSE(ShengDfa(large.get_dfa()).is_vectorized());
+}
+
+TEST(test_interleaved_dfa_matcher, test_matches_table) {
+    CompiledPattern pattern = PatternCompiler(*("ab"_r + "c"_r) * nth_from_end_regex(3)).compile();
+    const CompiledDfa &dfa = pattern.get_dfa();
+
+    // Uneven lengths, empty inputs, and inputs dying early
+    std::vector<std::string> words = random_words("abcx", 500, 40, 12);
+    words.emplace_back("");
+    words.emplace_back(200, 'a');
+
+    std::vector<std::string_view> inputs(words.begin(), words.end());
+
+    for (size_t lanes: {1, 4, 7, 16}) {
+        InterleavedDfaMatcher matcher(dfa, lanes);
+        std::vector<uint8_t> results = matcher.accepts(inputs);
+
+        ASSERT_EQ(results.size(), inputs.size());
+        for (size_t i = 0; i < inputs.size(); i++) {
+            EXPECT_EQ(results[i] != 0, dfa.accepts(inputs[i])) << lanes << " lanes, " << inputs[i];
+        }
+    }
+
+    EXPECT_TRUE(InterleavedDfaMatcher(dfa).accepts(std::span<const std::string_view>()).empty());
+}
+
+TEST(test_parallel_dfa_matcher, test_matches_sequential_run) {
+    RandomSource random(9);
+    ThreadPool pool(4);
+
+    // Small DFAs run the chunks from all the states, large ones from guesses
+    for (size_t state_count: {1, 5, 40, 400}) {
+        RandomAutomatonConfig config;
+        config.alphabet = "abcd";
+        config.state_count = state_count;
+        config.density = 1.0;
+        config.final_probability = 0.5;
+
+        CompiledDfa dfa(RandomAutomatonGenerator(config, state_count).generate());
+        ParallelDfaMatcher matcher(dfa, pool, 64, 100);
+
+        for (size_t length: {0, 10, 63, 64, 1000, 5000}) {
+            std::string input(length, ' ');
+            for (auto &c: input) {
+                c = random.next_char("abcdx");
+            }
+            // Without the x the runs mostly don't die early
+            if (length > 100) {
+                std::replace(input.begin(), input.end() - 50, 'x', 'a');
+            }
+
+            ParallelDfaMatchStats stats;
+            EXPECT_EQ(matcher.run(input, &stats), dfa.run(dfa.get_start_state(), input))
+                                << state_count << " states, length " << length;
+            EXPECT_EQ(matcher.accepts(input), dfa.accepts(input));
+            EXPECT_EQ(stats.used_full_maps, dfa.get_state_count() <= 100);
+            // Four chunks per thread, but none shorter than 64 bytes
+            size_t chunk_size = std::max<size_t>(64, (length + 15) / 16);
+            EXPECT_EQ(stats.chunks, (length + chunk_size - 1) / chunk_size);
+        }
+    }
+}
+
+TEST(test_line_scanner, test_matches_lines) {
+    std::vector<Regex> regexes = {"ab"_r * *"c"_r, *("ab"_r + "c"_r) * nth_from_end_regex(2), *"a"_r, Regex::zero()};
+
+    // Empty lines, a missing last line break, and lines without any match
+    std::string text;
+    for (auto &word: random_words("abcx", 300, 12, 5)) {
+        text += word + "\n";
+    }
+    text += "\n\nabcabc";
+
+    for (auto &regex: regexes) {
+        PatternSearcher searcher(regex);
+        CompiledPattern pattern = PatternCompiler(regex).compile();
+
+        for (auto mode: {LineMatchMode::Contains, LineMatchMode::Whole}) {
+            std::vector<LineSpan> expected;
+            size_t begin = 0;
+            for (size_t number = 0; begin < text.size(); number++) {
+                size_t end = std::min(text.find('\n', begin), text.size());
+                std::string_view line = std::string_view(text).substr(begin, end - begin);
+                if (mode == LineMatchMode::Contains ? searcher.contains(line) : pattern.accepts(line)) {
+                    expected.push_back({begin, end, number});
+                }
+                begin = end + 1;
+            }
+
+            for (bool use_prefilter: {false, true}) {
+                LineScanner scanner(regex, mode, use_prefilter);
+                EXPECT_EQ(scanner.scan(text), expected) << regex_to_string(regex);
+            }
+
+            // Whole lines go through the compiled engine
+            PatternCompilerOptions jit_options;
+            jit_options.jit = true;
+            LineScanner jit_scanner(regex, mode, true, jit_options);
+            EXPECT_EQ(jit_scanner.scan(text), expected) << regex_to_string(regex);
+            if (mode == LineMatchMode::Whole) {
+                EXPECT_EQ(jit_scanner.get_engine(), PatternCompiler(regex, jit_options).compile().get_engine());
+            } else {
+                EXPECT_EQ(jit_scanner.get_engine(), PatternEngine::Dfa);
+            }
+        }
+    }
+
+    EXPECT_FALSE(LineScanner("ab"_r * *"c"_r).get_literal().empty());
+    EXPECT_TRUE(LineScanner("a"_r, LineMatchMode::Contains, false).get_literal().empty());
+    EXPECT_TRUE(LineScanner("a"_r).scan("").empty());
+}
+
+TEST(test_line_scanner, test_stream_chunks) {
+    LineScanner scanner(*"a"_r * "bc"_r * *"a"_r, LineMatchMode::Whole);
+
+    std::string text;
+    for (auto &word: random_words("abcx", 200, 10, 6)) {
+        text += word + (word.size() % 3 ? "\n" : "abc\n");
+    }
+    text += "aabca";
+
+    std::vector<LineSpan> expected = scanner.scan(text);
+    ASSERT_FALSE(expected.empty());
+
+    // Chunks of every size from a single byte, so lines cross the borders anywhere
+    for (size_t chunk_size: {1, 2, 3, 7, 64, 1000}) {
+        LineScanStream stream(scanner);
+        std::vector<LineSpan> found;
+
+        for (size_t begin = 0; begin < text.size(); begin += chunk_size) {
+            stream.feed(std::string_view(text).substr(begin, chunk_size), found);
+            EXPECT_LE(stream.get_line_begin(), std::min(begin + chunk_size, text.size()));
+        }
+        stream.finish(found);
+
+        EXPECT_EQ(found, expected) << chunk_size;
+        EXPECT_EQ(stream.get_line_count(), std::count(text.begin(), text.end(), '\n') + 1);
+    }
+}
+
+TEST(test_line_scanner, test_falls_back_past_limits) {
+    // Far past the limits, the minimal DFA has 2^16 states
+    const size_t n = 16;
+    Regex regex = nth_from_end_regex(n);
+
+    PatternCompilerOptions options;
+    options.limits.max_states = 256;
+    options.lazy_cache_states = 1024;
+
+    std::string text;
+    for (auto &word: random_words("aaabbx", 200, 30, 11)) {
+        text += word + "\n";
+    }
+
+    // Some a followed by n - 1 more letters, at the end of the line in the Whole mode
+    auto matches = [&](std::string_view line, LineMatchMode mode) {
+        size_t run = 0;
+        for (size_t i = line.size(); i-- > 0;) {
+            run = line[i] == 'x' ? 0 : run + 1;
+            if (mode == LineMatchMode::Whole && run != line.size() - i) {
+                return false;
+            }
+            if (line[i] == 'a' && (mode == LineMatchMode::Whole ? run == n : run >= n)) {
+                return mode == LineMatchMode::Contains || line.substr(0, i).find('x') == std::string_view::npos;
+            }
+        }
+        return false;
+    };
+
+    for (auto mode: {LineMatchMode::Contains, LineMatchMode::Whole}) {
+        std::vector<LineSpan> expected;
+        size_t begin = 0;
+        for (size_t number = 0; begin < text.size(); number++) {
+            size_t end = text.find('\n', begin);
+            if (matches(std::string_view(text).substr(begin, end - begin), mode)) {
+                expected.push_back({begin, end, number});
+            }
+            begin = end + 1;
+        }
+        ASSERT_FALSE(expected.empty());
+
+        LineScanner scanner(regex, mode, true, options);
+        EXPECT_EQ(scanner.get_engine(), PatternEngine::LazyDfa);
+        EXPECT_FALSE(scanner.get_fallback_reason().empty());
+        EXPECT_EQ(scanner.scan(text), expected);
+
+        for (size_t chunk_size: {1, 5, 100}) {
+            LineScanStream stream(scanner);
+            std::vector<LineSpan> found;
+            for (size_t begin = 0; begin < text.size(); begin += chunk_size) {
+                stream.feed(std::string_view(text).substr(begin, chunk_size), found);
+            }
+            stream.finish(found);
+            EXPECT_EQ(found, expected) << chunk_size;
+        }
+    }
+}
+
+TEST(test_batch_matcher, test_matches_single_inputs) {
+    ThreadPool pool(3);
+
+    // Epsilon transitions are left in the automaton
+    Regex regex = *("ab"_r + "c"_r) * nth_from_end_regex(3);
+    FiniteAutomaton automaton(regex);
+    AutomatonSimplifier(automaton).simplify();
+    ASSERT_TRUE(automaton.has_epsilon_transitions());
+
+    CompiledDfa dfa(PatternCompiler(regex).compile().get_dfa());
+
+    // More than a block, with the last word of the bitmap only partly used
+    std::vector<std::string> words = random_words("abcx", 3 * BatchMatcher::block_size + 37, 12, 8);
+    std::vector<std::string_view> inputs(words.begin(), words.end());
+
+    std::string blob;
+    std::vector<size_t> offsets = {0};
+    for (auto &word: words) {
+        blob += word;
+        offsets.push_back(blob.size());
+    }
+
+    size_t expected_count = 0;
+    for (auto &word: words) {
+        expected_count += automaton.accepts(word);
+    }
+
+    for (auto &matcher: {BatchMatcher(automaton, pool), BatchMatcher(dfa, pool)}) {
+        MatchBitmap results = matcher.accepts(inputs);
+        MatchBitmap packed_results = matcher.accepts(blob, offsets);
+
+        ASSERT_EQ(results.size(), words.size());
+        for (size_t i = 0; i < words.size(); i++) {
+            EXPECT_EQ(results[i], automaton.accepts(words[i])) << words[i];
+        }
+        EXPECT_EQ(packed_results.get_words(), results.get_words());
+        EXPECT_EQ(results.count(), expected_count);
+    }
+
+    std::vector<size_t> no_offsets = {0};
+    EXPECT_EQ(BatchMatcher(dfa, pool).accepts("", no_offsets).size(), 0);
+    EXPECT_EQ(BatchMatcher(dfa, pool).accepts("", std::span<const size_t>()).size(), 0);
+    EXPECT_EQ(BatchMatcher(automaton, pool).accepts(std::span<const std::string_view>()).count(), 0);
+}